@@ -0,0 +1,307 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 Ensemble batch runs		<batch.c>
+///
+
+#include "batch.h"
+#include "pool.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define BATCH_PACK_CELLS 256  // Packs aim for about this many cells each way.
+
+struct Batch_Job {
+    const struct Batch_Config *config;
+    struct Batch_Result       *results;
+    uint64_t                  *col_mask;  // set on the columns of boards.
+    int                        across, down;  // boards per pack.
+    int                        nboard;
+    int                        failed;  // a pack ran out of memory.
+};
+
+// —————————————————————————————————————————————————————————————————————————————
+// BOARDS IN A PACK.
+
+// Bits [col, col + n) of a row as the low bits of a word, for n <= 64.
+static uint64_t row_bits(const uint64_t *row, int col, int n) {
+    int      w = col >> 6, shift = col & 63;
+    uint64_t bits = row[w] >> shift;
+
+    if (shift != 0 && shift + n > 64) bits |= row[w + 1] << (64 - shift);
+    return n == 64 ? bits : bits & ((1ull << n) - 1);
+}
+
+// OR the low bits of `bits` into a row from column `col` on. Only the pad
+// word may see the bits shifted past the last column, and those are zero.
+static void or_bits(uint64_t *row, int col, uint64_t bits) {
+    int w = col >> 6, shift = col & 63;
+
+    row[w] |= bits << shift;
+    if (shift != 0) row[w + 1] |= bits >> (64 - shift);
+}
+
+// Hash of the board with its top left at (r0, c0). `*any` tells whether it
+// has a live cell.
+static uint64_t board_hash(const struct Grid *pack, int r0, int c0, int nrow,
+                           int ncol, int *any) {
+    uint64_t hash = 0, seen = 0;
+
+    for (int i = 0; i < nrow; i += 1) {
+        const uint64_t *row = grid_row(pack, r0 + i);
+
+        for (int j = 0; j < ncol; j += 64) {
+            int      n    = ncol - j < 64 ? ncol - j : 64;
+            uint64_t bits = row_bits(row, c0 + j, n);
+
+            hash  = (hash ^ bits) * 0x9E3779B97F4A7C15ull;
+            hash ^= hash >> 29;
+            seen |= bits;
+        }
+    }
+    *any = seen != 0;
+    return hash;
+}
+
+// Fill in the population and bounding box of the board at (r0, c0).
+static void board_summary(const struct Grid *pack, int r0, int c0, int nrow,
+                          int ncol, struct Batch_Result *result) {
+    result->population = 0;
+    result->top = result->left = result->bottom = result->right = -1;
+    for (int i = 0; i < nrow; i += 1) {
+        const uint64_t *row = grid_row(pack, r0 + i);
+
+        for (int j = 0; j < ncol; j += 64) {
+            int      n    = ncol - j < 64 ? ncol - j : 64;
+            uint64_t bits = row_bits(row, c0 + j, n);
+
+            if (bits == 0) continue;
+            int lo = j + __builtin_ctzll(bits);
+            int hi = j + 63 - __builtin_clzll(bits);
+
+            result->population += __builtin_popcountll(bits);
+            if (result->top < 0) result->top = i;
+            result->bottom = i;
+            if (result->left < 0 || lo < result->left) result->left = lo;
+            if (hi > result->right) result->right = hi;
+        }
+    }
+}
+
+static uint64_t splitmix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Seed board `index` at (r0, c0) of `pack`, loading patterns through the
+// zeroed `scratch` grid of one board. Returns 0, or -1 with `result` filled
+// in if the pattern failed to load.
+static int seed_board(const struct Batch_Config *config, int index,
+                      struct Grid *pack, int r0, int c0, struct Grid *scratch,
+                      struct Batch_Result *result) {
+    if (config->npath == 0) {
+        uint64_t state     = index;
+        uint64_t threshold = config->density >= 1
+                                 ? UINT64_MAX  // 2^64 does not convert.
+                                 : (uint64_t)(config->density * 0x1p64);
+
+        for (int i = 0; i < config->nrow; i += 1) {
+            for (int j = 0; j < config->ncol; j += 1) {
+                if (config->density >= 1 || splitmix64(&state) < threshold)
+                    grid_set(pack, r0 + i, c0 + j, 1);
+            }
+        }
+        return 0;
+    }
+    memset(scratch->cells, 0, grid_size(scratch->nrow, scratch->ncol));
+    if (pattern_load(scratch, config->paths[index], config->top, config->left,
+                     &result->error) != 0) {
+        result->status = BATCH_FAILED;
+        return -1;
+    }
+    for (int i = 0; i < config->nrow; i += 1) {
+        const uint64_t *row = grid_row(scratch, i);
+
+        for (int j = 0; j < config->ncol; j += 64) {
+            int n = config->ncol - j < 64 ? config->ncol - j : 64;
+
+            or_bits(grid_row(pack, r0 + i), c0 + j, row_bits(row, j, n));
+        }
+    }
+    return 0;
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// RUNNING A PACK.
+
+static void run_pack(void *ctx, int pack_index) {
+    struct Batch_Job          *job      = ctx;
+    const struct Batch_Config *config   = job->config;
+    const int                  per_pack = job->across * job->down;
+    const int                  first    = pack_index * per_pack;
+    const int count = job->nboard - first < per_pack ? job->nboard - first
+                                                     : per_pack;
+    const int pack_nrow = job->down * (config->nrow + 1) - 1;
+    const int pack_ncol = job->across * (config->ncol + 1) - 1;
+    // Under a B0 rule empty space comes alive, so an empty board is no end.
+    const int            can_die = !(config->rule.birth & 1);
+    struct Grid          front, back, scratch = {0};
+    struct Cycle_Finder *finders = calloc(count, sizeof(*finders));
+    int                  running = 0;
+
+    if (finders == NULL || grid_init(&front, pack_nrow, pack_ncol) != 0) {
+        free(finders);
+        __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    if (grid_init(&back, pack_nrow, pack_ncol) != 0 ||
+        (config->npath > 0 &&
+         grid_init(&scratch, config->nrow, config->ncol) != 0)) {
+        grid_free(&front);
+        grid_free(&back);
+        free(finders);
+        __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    for (int k = 0; k < count; k += 1) {
+        struct Batch_Result *result = &job->results[first + k];
+        int r0 = (k / job->across) * (config->nrow + 1);
+        int c0 = (k % job->across) * (config->ncol + 1);
+        int any;
+
+        result->status     = BATCH_ALIVE;
+        result->generation = 0;
+        result->period     = 0;
+        result->population = 0;
+        result->top = result->left = result->bottom = result->right = -1;
+        if (seed_board(config, first + k, &front, r0, c0, &scratch, result) !=
+            0)
+            continue;
+        uint64_t hash = board_hash(&front, r0, c0, config->nrow, config->ncol,
+                                   &any);
+        if (!any && can_die) {
+            result->status     = BATCH_DIED;
+            result->generation = 0;
+            board_summary(&front, r0, c0, config->nrow, config->ncol, result);
+            continue;
+        }
+        if (config->max_period > 0) {
+            if (cycle_init(&finders[k], config->max_period) != 0) {
+                __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+                break;
+            }
+            cycle_push(&finders[k], hash);
+        }
+        running += 1;
+    }
+
+    uint64_t gen = 0;
+    while (running > 0 && gen < config->generations && !job->failed) {
+        update_state(&back, &front, config->rule);
+        for (int i = 0; i < pack_nrow; i += 1) {  // Clear the gaps.
+            uint64_t *row = grid_row(&back, i);
+
+            if ((i + 1) % (config->nrow + 1) == 0) {
+                memset(row, 0, sizeof(uint64_t) * back.nword);
+                continue;
+            }
+            for (int w = 0; w < back.nword; w += 1) row[w] &= job->col_mask[w];
+        }
+        struct Grid tmp = front;
+        front           = back;
+        back            = tmp;
+        gen            += 1;
+
+        for (int k = 0; k < count; k += 1) {
+            struct Batch_Result *result = &job->results[first + k];
+            int r0 = (k / job->across) * (config->nrow + 1);
+            int c0 = (k % job->across) * (config->ncol + 1);
+            int any, period = 0;
+
+            if (result->status != BATCH_ALIVE) continue;
+            uint64_t hash = board_hash(&front, r0, c0, config->nrow,
+                                       config->ncol, &any);
+            if (!any && can_die) {
+                result->status     = BATCH_DIED;
+                result->generation = gen;
+            } else if (config->max_period > 0 &&
+                       (period = cycle_push(&finders[k], hash)) > 0) {
+                result->status     = BATCH_CYCLED;
+                result->generation = gen - period;
+                result->period     = period;
+            } else {
+                continue;
+            }
+            board_summary(&front, r0, c0, config->nrow, config->ncol, result);
+            running -= 1;
+        }
+    }
+    for (int k = 0; k < count; k += 1) {
+        struct Batch_Result *result = &job->results[first + k];
+
+        if (result->status == BATCH_ALIVE) {
+            result->generation = gen;
+            board_summary(&front, (k / job->across) * (config->nrow + 1),
+                          (k % job->across) * (config->ncol + 1), config->nrow,
+                          config->ncol, result);
+        }
+        cycle_free(&finders[k]);
+    }
+    grid_free(&front);
+    grid_free(&back);
+    grid_free(&scratch);
+    free(finders);
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// BATCH.
+
+int batch_count(const struct Batch_Config *config) {
+    return config->npath > 0 ? config->npath : config->nrandom;
+}
+
+int batch_run(const struct Batch_Config *config, struct Pool *pool,
+              struct Batch_Result *results) {
+    struct Batch_Job job = {config, results};
+
+    job.across = (BATCH_PACK_CELLS + 1) / (config->ncol + 1);
+    job.down   = (BATCH_PACK_CELLS + 1) / (config->nrow + 1);
+    if (job.across < 1) job.across = 1;
+    if (job.down < 1) job.down = 1;
+    job.nboard = batch_count(config);
+
+    // One spare word, like a row's pad, for `or_bits` to spill into.
+    int nword    = (job.across * (config->ncol + 1) - 1 + 63) / 64;
+    job.col_mask = calloc(nword + 1, sizeof(uint64_t));
+    if (job.col_mask == NULL) return -1;
+    for (int k = 0; k < job.across; k += 1) {
+        for (int j = 0; j < config->ncol; j += 64) {
+            int n = config->ncol - j < 64 ? config->ncol - j : 64;
+
+            or_bits(job.col_mask, k * (config->ncol + 1) + j,
+                    n == 64 ? ~0ull : (1ull << n) - 1);
+        }
+    }
+
+    int npack = (job.nboard + job.across * job.down - 1) /
+                (job.across * job.down);
+    if (pool != NULL) {
+        pool_run(pool, npack, run_pack, &job);
+    } else {
+        for (int p = 0; p < npack; p += 1) run_pack(&job, p);
+    }
+    free(job.col_mask);
+
+    return job.failed ? -1 : 0;
+}
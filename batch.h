@@ -0,0 +1,70 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 Ensemble batch runs		<batch.h>
+///
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdint.h>
+
+#include "grid.h"
+#include "pattern.h"
+
+struct Pool;
+
+// —————————————————————————————————————————————————————————————————————————————
+// ENSEMBLE OF BOARDS.
+//
+// Runs many independent boards of one size to a target generation. Boards
+// are packed side by side into larger grids, one dead row and column apart,
+// so a single kernel pass steps dozens of small boards in the same words and
+// vectors. After every step the gaps are cleared again, so no board ever
+// sees a neighbour. Each pack is one task for the pool, and a pack stops
+// once every board in it died out, entered a cycle or reached the target.
+struct Batch_Config {
+    int         nrow, ncol;   // of every board.
+    struct Rule rule;
+    uint64_t    generations;  // target.
+    int         max_period;   // longest cycle looked for, 0 for none.
+    // Seeds: the pattern files `paths[0 .. npath)` if any, else `nrandom`
+    // boards filled at `density`, board k from random seed k.
+    char      **paths;
+    int         npath;
+    int         nrandom;
+    double      density;
+    int         top, left;  // where patterns go on their board.
+};
+
+enum Batch_Status {
+    BATCH_ALIVE,   // still changing at the target generation.
+    BATCH_DIED,    // no live cells left.
+    BATCH_CYCLED,  // repeating a cycle of `period` generations.
+    BATCH_FAILED,  // the seed pattern could not be loaded.
+};
+
+struct Batch_Result {
+    enum Batch_Status status;
+    uint64_t          generation;  // of death or cycle start, else the last.
+    int               period;      // for BATCH_CYCLED, 1 for a still life.
+    uint64_t          population;  // when the board stopped.
+    int               top, left, bottom, right;  // live cells, -1 if none.
+    struct Pattern_Error error;                  // for BATCH_FAILED.
+};
+
+// Number of boards `config` asks for.
+int batch_count(const struct Batch_Config *config);
+// Run every board, filling `results[0 .. batch_count)`. `pool` may be NULL.
+// Returns 0, or -1 if out of memory.
+int batch_run(const struct Batch_Config *config, struct Pool *pool,
+              struct Batch_Result *results);
+
+#endif  // BATCH_H
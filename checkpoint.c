@@ -0,0 +1,249 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 Checkpoint files		<checkpoint.c>
+///
+
+#include "checkpoint.h"
+#include "profile.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// —————————————————————————————————————————————————————————————————————————————
+// CHECKSUM.
+
+// Four independent multiply-rotate lanes, so the hash keeps up with reading
+// the file instead of waiting on one long multiply chain.
+static uint64_t checksum_cells(const uint64_t *cells, size_t size) {
+    const uint64_t prime = 0x9E3779B97F4A7C15ull;
+    uint64_t       lane[4] = {1, 2, 3, 4};
+    size_t         nword = size / sizeof(uint64_t), k = 0;
+
+    for (; k + 4 <= nword; k += 4) {
+        for (int l = 0; l < 4; l += 1) {
+            uint64_t h = (lane[l] ^ cells[k + l]) * prime;
+            lane[l]    = h << 31 | h >> 33;
+        }
+    }
+    for (; k < nword; k += 1) lane[0] = (lane[0] ^ cells[k]) * prime;
+
+    uint64_t hash = size;
+    for (int l = 0; l < 4; l += 1) hash = (hash ^ lane[l]) * prime;
+    return hash ^ hash >> 29;
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// RESUME.
+
+int checkpoint_read_header(const char *path, struct Checkpoint_Header *header,
+                           const char **error) {
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0) {
+        *error = strerror(errno);
+        return -1;
+    }
+    ssize_t n = pread(fd, header, sizeof(*header), 0);
+    close(fd);
+    if (n != sizeof(*header) ||
+        memcmp(header->magic, CHECKPOINT_MAGIC, sizeof(header->magic)) != 0)
+        *error = "not a checkpoint file";
+    else if (header->byte_order != CHECKPOINT_BYTE_ORDER)
+        *error = "checkpoint written on a machine of other byte order";
+    else if (header->version != CHECKPOINT_VERSION)
+        *error = "unsupported checkpoint version";
+    else if (header->header_size < sizeof(*header) ||
+             header->header_size % 64 != 0 || header->nrow == 0 || header->ncol == 0 ||
+             header->nrow > INT32_MAX || header->ncol > INT32_MAX ||
+             header->cells_size != grid_size(header->nrow, header->ncol))
+        *error = "corrupt checkpoint header";
+    else if (header->rule_birth >= 1 << 9 || header->rule_survive >= 1 << 9)
+        *error = "checkpoint uses an unsupported rule";
+    else if (header->topology > TOPOLOGY_MIRROR)
+        *error = "checkpoint uses an unsupported topology";
+    else
+        return 0;
+    return -1;
+}
+
+int checkpoint_resume(struct Board *board, const char *path,
+                      const char **error) {
+    struct Checkpoint_Header header;
+    struct stat              st;
+
+    if (checkpoint_read_header(path, &header, error) != 0) return -1;
+    if ((int)header.nrow != board->front.nrow ||
+        (int)header.ncol != board->front.ncol ||
+        (int)header.stride != board->front.stride) {
+        *error = "checkpoint does not match the board size";
+        return -1;
+    }
+    if (header.rule_birth != board->rule.birth ||
+        header.rule_survive != board->rule.survive) {
+        *error = "checkpoint was saved under another rule: pass its --rule";
+        return -1;
+    }
+    if (header.topology != board->topology) {
+        *error = "checkpoint was saved with another --topology";
+        return -1;
+    }
+    int fd = open(path, O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        *error = strerror(errno);
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    if ((uint64_t)st.st_size < header.header_size + header.cells_size) {
+        close(fd);
+        *error = "checkpoint file is truncated";
+        return -1;
+    }
+    // Private and writable: steps may later use these pages as a buffer,
+    // and the kernel copies a page only when it is first written. The map
+    // starts at offset 0, which is on a page boundary whatever the page
+    // size, and the cells start `header_size` bytes in.
+    const size_t size    = header.header_size + header.cells_size;
+    void        *mapping = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        *error = strerror(errno);
+        return -1;
+    }
+    uint64_t *cells = (uint64_t *)((char *)mapping + header.header_size);
+    if (checksum_cells(cells, header.cells_size) != header.checksum) {
+        munmap(mapping, size);
+        *error = "checkpoint checksum mismatch";
+        return -1;
+    }
+    board_map_front(board, mapping, size, cells);
+    board->generation = header.generation;
+
+    return 0;
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// BACKGROUND WRITER.
+
+static int write_snapshot(struct Checkpointer *ck) {
+    static char              page[CHECKPOINT_HEADER_SIZE];
+    struct Checkpoint_Header header = {
+        .magic        = CHECKPOINT_MAGIC,
+        .version      = CHECKPOINT_VERSION,
+        .byte_order   = CHECKPOINT_BYTE_ORDER,
+        .header_size  = CHECKPOINT_HEADER_SIZE,
+        .nrow         = ck->snapshot.nrow,
+        .ncol         = ck->snapshot.ncol,
+        .stride       = ck->snapshot.stride,
+        .rule_birth   = ck->rule.birth,
+        .rule_survive = ck->rule.survive,
+        .topology     = ck->topology,
+        .generation   = ck->generation,
+        .cells_size   = grid_size(ck->snapshot.nrow, ck->snapshot.ncol),
+    };
+    header.checksum = checksum_cells(ck->snapshot.cells, header.cells_size);
+    memcpy(page, &header, sizeof(header));  // The rest stays zero.
+
+    FILE *file = fopen(ck->tmp_path, "wb");
+    if (file == NULL) return errno;
+    if (fwrite(page, 1, sizeof(page), file) != sizeof(page) ||
+        fwrite(ck->snapshot.cells, 1, header.cells_size, file) !=
+            header.cells_size ||
+        fflush(file) != 0 || fsync(fileno(file)) != 0) {
+        int err = errno;
+        fclose(file);
+        return err;
+    }
+    if (fclose(file) != 0 || rename(ck->tmp_path, ck->path) != 0) return errno;
+
+    return 0;
+}
+
+static void *writer_main(void *arg) {
+    struct Checkpointer *ck = arg;
+
+    pthread_mutex_lock(&ck->lock);
+    while (1) {
+        while (!ck->pending && !ck->stop)
+            pthread_cond_wait(&ck->cond, &ck->lock);
+        if (!ck->pending) break;  // Stopping with nothing left to write.
+        pthread_mutex_unlock(&ck->lock);
+        PROBE1(checkpoint_write_start, ck->generation);
+        int err = write_snapshot(ck);
+        PROBE2(checkpoint_write_done, ck->generation, err);
+        pthread_mutex_lock(&ck->lock);
+        if (err != 0) ck->error = err;
+        ck->pending = 0;
+        pthread_cond_broadcast(&ck->cond);
+    }
+    pthread_mutex_unlock(&ck->lock);
+    return NULL;
+}
+
+int checkpoint_start(struct Checkpointer *ck, const char *path, int nrow,
+                     int ncol) {
+    ck->path       = path;
+    ck->tmp_path   = malloc(strlen(path) + sizeof(".tmp"));
+    ck->generation = 0;
+    ck->pending    = 0;
+    ck->stop       = 0;
+    ck->error      = 0;
+    if (ck->tmp_path == NULL) return -1;
+    sprintf(ck->tmp_path, "%s.tmp", path);
+    if (grid_init(&ck->snapshot, nrow, ncol) != 0) {
+        free(ck->tmp_path);
+        return -1;
+    }
+    pthread_mutex_init(&ck->lock, NULL);
+    pthread_cond_init(&ck->cond, NULL);
+    if (pthread_create(&ck->thread, NULL, writer_main, ck) != 0) {
+        pthread_mutex_destroy(&ck->lock);
+        pthread_cond_destroy(&ck->cond);
+        grid_free(&ck->snapshot);
+        free(ck->tmp_path);
+        return -1;
+    }
+    return 0;
+}
+
+void checkpoint_post(struct Checkpointer *ck, const struct Board *board) {
+    pthread_mutex_lock(&ck->lock);
+    while (ck->pending) pthread_cond_wait(&ck->cond, &ck->lock);
+    pthread_mutex_unlock(&ck->lock);
+    grid_copy(&ck->snapshot, &board->front);  // The writer is idle.
+    pthread_mutex_lock(&ck->lock);
+    ck->generation = board->generation;
+    ck->rule       = board->rule;
+    ck->topology   = board->topology;
+    ck->pending    = 1;
+    pthread_cond_broadcast(&ck->cond);
+    pthread_mutex_unlock(&ck->lock);
+}
+
+int checkpoint_stop(struct Checkpointer *ck) {
+    pthread_mutex_lock(&ck->lock);
+    ck->stop = 1;
+    pthread_cond_broadcast(&ck->cond);
+    pthread_mutex_unlock(&ck->lock);
+    pthread_join(ck->thread, NULL);
+    pthread_mutex_destroy(&ck->lock);
+    pthread_cond_destroy(&ck->cond);
+    grid_free(&ck->snapshot);
+    free(ck->tmp_path);
+
+    return ck->error;
+}
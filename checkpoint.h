@@ -0,0 +1,89 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 Checkpoint files		<checkpoint.h>
+///
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include "grid.h"
+
+// —————————————————————————————————————————————————————————————————————————————
+// CHECKPOINT FILE.
+//
+// A header of `header_size` bytes, then the grid's cells exactly as they
+// are laid out in memory, pad rows and words included. Resuming maps the
+// whole file and points the front grid past the header, so it steps
+// straight from the mapped pages, with no parsing or copying, and the
+// header need not fill a page of any particular size. Integers are in the
+// writer's byte order, which `byte_order` lets a reader check.
+#define CHECKPOINT_MAGIC       "GOLCKPT\0"
+#define CHECKPOINT_VERSION     1
+#define CHECKPOINT_HEADER_SIZE 4096  // written; a multiple of 64 is read.
+#define CHECKPOINT_BYTE_ORDER  0x01020304
+
+struct Checkpoint_Header {
+    char     magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t header_size;   // offset of the cells, a multiple of 64.
+    uint32_t nrow, ncol;
+    uint32_t stride;        // words per padded row.
+    uint16_t rule_birth;    // bit n: a dead cell with n neighbours is born.
+    uint16_t rule_survive;  // bit n: a live cell with n neighbours lives.
+    uint32_t topology;      // enum Topology, so 0 is dead edges.
+    uint64_t generation;
+    uint64_t cells_size;    // bytes.
+    uint64_t checksum;      // of the cells.
+};
+
+// Read and check the header of `path`. Returns 0, or -1 with `*error` set.
+int checkpoint_read_header(const char *path, struct Checkpoint_Header *header,
+                           const char **error);
+// Map the cells of `path` as the front grid of `board`, which must be fresh
+// from `board_init` with the checkpoint's dimensions and set to its rule
+// and topology, and restore its generation. Returns 0, or -1 with `*error` set.
+int checkpoint_resume(struct Board *board, const char *path,
+                      const char **error);
+
+// —————————————————————————————————————————————————————————————————————————————
+// BACKGROUND WRITER.
+//
+// `checkpoint_post` copies the front grid into a snapshot and returns; a
+// writer thread then checksums it and writes it to a temporary file that is
+// renamed over `path`, so a crash mid-write leaves the last checkpoint
+// intact. A post only waits if the previous snapshot is still being written.
+struct Checkpointer {
+    const char     *path;
+    char           *tmp_path;
+    pthread_t       thread;
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    struct Grid     snapshot;
+    uint64_t        generation;  // of the snapshot.
+    struct Rule     rule;        // the snapshot evolves under.
+    enum Topology   topology;
+    int             pending;     // snapshot waiting to be written.
+    int             stop;
+    int             error;       // errno of the last failed write, or 0.
+};
+
+int checkpoint_start(struct Checkpointer *ck, const char *path, int nrow,
+                     int ncol);
+void checkpoint_post(struct Checkpointer *ck, const struct Board *board);
+// Finish any pending write and stop the writer. Returns 0, or the errno of
+// a failed write.
+int checkpoint_stop(struct Checkpointer *ck);
+
+#endif  // CHECKPOINT_H
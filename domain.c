@@ -0,0 +1,371 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 Multi-process domain decomposition		<domain.c>
+///
+
+#define _GNU_SOURCE  // sched_setaffinity and the CPU_* macros.
+
+#include "domain.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define DOMAIN_SPINS 256  // looks at a neighbour's counter before yielding.
+
+enum Edge { EDGE_TOP, EDGE_BOTTOM };
+
+// Shared memory: this header, a flag per worker, then the edge slots and the
+// cells the workers hand back.
+struct Domain_Shared {
+    int  failed;  // a worker died, so its neighbours would wait forever.
+    char pad[60];
+};
+
+struct Domain_Flag {  // A cache line each, written by its worker only.
+    uint64_t published;  // generations whose edges are in the slots.
+    char     pad[56];
+};
+
+struct Worker {
+    const struct Board   *board;
+    enum Halo_Transport   transport;
+    int                   k, nproc;
+    int                   r0, n;  // first row on the board, and row count.
+    int                   nword;
+    struct Domain_Shared *shared;
+    struct Domain_Flag   *flags;
+    uint64_t             *edges;   // [worker][parity][edge][word].
+    uint64_t             *result;  // the board's rows, unpadded.
+    int                   fd_up, fd_down;  // sockets, -1 past the board.
+    struct Grid           front, back;
+};
+
+// —————————————————————————————————————————————————————————————————————————————
+// PINNING.
+
+// Fill `set` with the CPUs of NUMA node `node`. Returns 0, or -1 if the
+// kernel does not list that node.
+static int node_cpus(int node, cpu_set_t *set) {
+    char  path[64];
+    FILE *list;
+    int   lo, hi, c = ',';
+
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist",
+             node);
+    if ((list = fopen(path, "r")) == NULL) return -1;
+    CPU_ZERO(set);
+    while (c == ',' && fscanf(list, "%d", &lo) == 1) {  // e.g. "0-3,8-11".
+        hi = lo;
+        if ((c = fgetc(list)) == '-') {
+            if (fscanf(list, "%d", &hi) != 1) break;
+            c = fgetc(list);
+        }
+        for (int cpu = lo; cpu <= hi && cpu < CPU_SETSIZE; cpu += 1)
+            CPU_SET(cpu, set);
+    }
+    fclose(list);
+    return 0;
+}
+
+// Pin the calling worker to NUMA node `k` modulo the node count. Best
+// effort: with no NUMA information, or a cpuset that forbids it, the
+// scheduler places the worker as before.
+static void pin_to_node(int k) {
+    cpu_set_t set;
+    int       nnode = 0;
+
+    while (node_cpus(nnode, &set) == 0) nnode += 1;
+    if (nnode == 0 || node_cpus(k % nnode, &set) != 0 || CPU_COUNT(&set) == 0)
+        return;
+    (void)sched_setaffinity(0, sizeof(set), &set);
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// SHARED MEMORY HALO.
+//
+// A worker copies its edge rows of generation g into the slots of parity
+// g % 2 and then raises its counter to g + 1. Its neighbours wait for that
+// and copy the rows into their halo. It only writes the same slots again
+// for generation g + 2, which needs their edges of g + 1, which they
+// publish after they took in these.
+
+static uint64_t *edge_slot(const struct Worker *w, int k, uint64_t g,
+                           enum Edge edge) {
+    return w->edges + (((size_t)k * 2 + g % 2) * 2 + edge) * w->nword;
+}
+
+static void shm_publish(struct Worker *w, uint64_t g) {
+    const size_t bytes = sizeof(uint64_t) * w->nword;
+
+    memcpy(edge_slot(w, w->k, g, EDGE_TOP), grid_row(&w->front, 0), bytes);
+    memcpy(edge_slot(w, w->k, g, EDGE_BOTTOM), grid_row(&w->front, w->n - 1),
+           bytes);
+    __atomic_store_n(&w->flags[w->k].published, g + 1, __ATOMIC_RELEASE);
+}
+
+// Wait for worker `k` to publish generation g. Returns 0, or -1 if a worker
+// failed.
+static int shm_wait(struct Worker *w, int k, uint64_t g) {
+    for (int spins = 0;
+         __atomic_load_n(&w->flags[k].published, __ATOMIC_ACQUIRE) <= g;
+         spins += 1) {
+        if (__atomic_load_n(&w->shared->failed, __ATOMIC_RELAXED)) return -1;
+        if (spins >= DOMAIN_SPINS) sched_yield();
+    }
+    return 0;
+}
+
+static int shm_fetch(struct Worker *w, uint64_t g) {
+    const size_t bytes = sizeof(uint64_t) * w->nword;
+
+    if (w->k > 0) {
+        if (shm_wait(w, w->k - 1, g) != 0) return -1;
+        memcpy(grid_row(&w->front, -1), edge_slot(w, w->k - 1, g, EDGE_BOTTOM),
+               bytes);
+    }
+    if (w->k + 1 < w->nproc) {
+        if (shm_wait(w, w->k + 1, g) != 0) return -1;
+        memcpy(grid_row(&w->front, w->n), edge_slot(w, w->k + 1, g, EDGE_TOP),
+               bytes);
+    }
+    return 0;
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// SOCKET HALO.
+//
+// Each neighbour socket sends an edge row straight from the grid and
+// receives the neighbour's into the pad row, without blocking, so both
+// directions make progress whatever the socket buffers hold.
+
+struct Transfer {
+    int            fd;
+    const uint8_t *out;
+    size_t         nout;
+    uint8_t       *in;
+    size_t         nin;
+};
+
+// Move what the socket takes and holds now. Returns 0, or -1 on error.
+static int transfer_some(struct Transfer *t) {
+    while (t->nout > 0) {
+        ssize_t n = send(t->fd, t->out, t->nout, MSG_DONTWAIT | MSG_NOSIGNAL);
+
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return -1;
+        }
+        t->out  += n;
+        t->nout -= n;
+    }
+    while (t->nin > 0) {
+        ssize_t n = recv(t->fd, t->in, t->nin, MSG_DONTWAIT);
+
+        if (n == 0) {  // The neighbour is gone.
+            errno = EPIPE;
+            return -1;
+        }
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return -1;
+        }
+        t->in  += n;
+        t->nin -= n;
+    }
+    return 0;
+}
+
+// Set up the exchange of the current edges and start it.
+static int socket_start(struct Worker *w, struct Transfer t[2]) {
+    const size_t bytes = sizeof(uint64_t) * w->nword;
+
+    t[0] = (struct Transfer){w->fd_up, (const uint8_t *)grid_row(&w->front, 0),
+                             bytes, (uint8_t *)grid_row(&w->front, -1), bytes};
+    t[1] = (struct Transfer){
+        w->fd_down, (const uint8_t *)grid_row(&w->front, w->n - 1), bytes,
+        (uint8_t *)grid_row(&w->front, w->n), bytes};
+    for (int s = 0; s < 2; s += 1) {
+        if (t[s].fd < 0) t[s].nout = t[s].nin = 0;
+        else if (transfer_some(&t[s]) != 0) return -1;
+    }
+    return 0;
+}
+
+static int socket_finish(struct Transfer t[2]) {
+    for (;;) {
+        struct pollfd pfd[2];
+        int           npfd = 0;
+
+        for (int s = 0; s < 2; s += 1) {
+            if (t[s].nout == 0 && t[s].nin == 0) continue;
+            pfd[npfd++] = (struct pollfd){
+                t[s].fd, (t[s].nout ? POLLOUT : 0) | (t[s].nin ? POLLIN : 0)};
+        }
+        if (npfd == 0) return 0;
+        if (poll(pfd, npfd, -1) < 0 && errno != EINTR) return -1;
+        for (int s = 0; s < 2; s += 1) {
+            if (t[s].fd >= 0 && transfer_some(&t[s]) != 0) return -1;
+        }
+    }
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// WORKER.
+
+static int worker_run(struct Worker *w, uint64_t ngen) {
+    const struct Grid *board = &w->board->front;
+    const struct Rule  rule  = w->board->rule;
+    const size_t       bytes = sizeof(uint64_t) * w->nword;
+
+    pin_to_node(w->k);  // Before the stripe is touched, to allocate it there.
+    if (grid_init(&w->front, w->n, board->ncol) != 0 ||
+        grid_init(&w->back, w->n, board->ncol) != 0)
+        return -1;
+    for (int i = 0; i < w->n; i += 1)
+        memcpy(grid_row(&w->front, i), grid_row(board, w->r0 + i), bytes);
+
+    for (uint64_t g = 0; g < ngen; g += 1) {
+        struct Transfer t[2];
+
+        if (w->transport == HALO_SHM) shm_publish(w, g);
+        else if (socket_start(w, t) != 0) return -1;
+        // The rows in between while the halo is on its way.
+        if (w->n > 2) update_state_rows(&w->back, &w->front, rule, 1, w->n - 1);
+        if ((w->transport == HALO_SHM ? shm_fetch(w, g) : socket_finish(t)) !=
+            0)
+            return -1;
+        update_state_rows(&w->back, &w->front, rule, 0, 1);
+        if (w->n > 1)
+            update_state_rows(&w->back, &w->front, rule, w->n - 1, w->n);
+
+        struct Grid tmp = w->front;
+        w->front        = w->back;
+        w->back         = tmp;
+    }
+    for (int i = 0; i < w->n; i += 1)
+        memcpy(w->result + (size_t)(w->r0 + i) * w->nword,
+               grid_row(&w->front, i), bytes);
+    return 0;
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// COORDINATOR.
+
+int domain_run(struct Board *board, uint64_t ngen,
+               const struct Domain_Config *config) {
+    static int   nrun  = 0;
+    struct Grid *grid  = &board->front;
+    const int    nproc = config->nproc < grid->nrow ? config->nproc
+                                                    : grid->nrow;
+    const size_t nword = grid->nword;
+    const size_t size  = sizeof(struct Domain_Shared) +
+                        nproc * sizeof(struct Domain_Flag) +
+                        ((size_t)nproc * 4 + grid->nrow) * nword *
+                            sizeof(uint64_t);
+    char         name[64];
+    int          fd, nstarted = 0, failed = 0, err = 0;
+    int (*pairs)[2] = malloc(nproc * sizeof(*pairs));  // between k and k + 1.
+    void        *map = MAP_FAILED;
+
+    if (pairs == NULL) goto fail;
+    for (int k = 0; k < nproc; k += 1) pairs[k][0] = pairs[k][1] = -1;
+    snprintf(name, sizeof(name), "/gameoflife-%d-%d", (int)getpid(), nrun++);
+    if ((fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600)) < 0) goto fail;
+    shm_unlink(name);  // Gone once the last mapping is.
+    if (ftruncate(fd, size) == 0)
+        map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) goto fail;
+    for (int k = 0; config->transport == HALO_SOCKET && k + 1 < nproc; k += 1)
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, pairs[k]) != 0) goto fail;
+
+    struct Worker w = {
+        .board     = board,
+        .transport = config->transport,
+        .nproc     = nproc,
+        .nword     = (int)nword,
+        .shared    = map,
+        .flags     = (struct Domain_Flag *)((struct Domain_Shared *)map + 1),
+    };
+    w.edges  = (uint64_t *)(w.flags + nproc);
+    w.result = w.edges + (size_t)nproc * 4 * nword;
+    fflush(NULL);  // Or the workers would write out what is buffered again.
+    for (; nstarted < nproc; nstarted += 1) {
+        const int k = nstarted;
+        pid_t     pid;
+
+        if ((pid = fork()) < 0) {
+            err = errno;
+            __atomic_store_n(&w.shared->failed, 1, __ATOMIC_RELAXED);
+            break;
+        }
+        if (pid == 0) {
+            w.k       = k;
+            w.r0      = (int)((int64_t)grid->nrow * k / nproc);
+            w.n       = (int)((int64_t)grid->nrow * (k + 1) / nproc) - w.r0;
+            w.fd_up   = k > 0 ? pairs[k - 1][1] : -1;
+            w.fd_down = pairs[k][0];
+            for (int j = 0; j + 1 < nproc; j += 1) {  // Keep only our own.
+                if (pairs[j][0] >= 0 && pairs[j][0] != w.fd_down)
+                    close(pairs[j][0]);
+                if (pairs[j][1] >= 0 && pairs[j][1] != w.fd_up)
+                    close(pairs[j][1]);
+            }
+            _exit(worker_run(&w, ngen) == 0 ? 0 : 1);
+        }
+    }
+    for (int k = 0; k + 1 < nproc; k += 1) {
+        if (pairs[k][0] >= 0) close(pairs[k][0]);
+        if (pairs[k][1] >= 0) close(pairs[k][1]);
+        pairs[k][0] = pairs[k][1] = -1;
+    }
+    for (int k = 0; k < nstarted; k += 1) {  // In whatever order they end.
+        int status;
+
+        if (wait(&status) < 0 || !WIFEXITED(status) ||
+            WEXITSTATUS(status) != 0) {
+            failed = 1;
+            __atomic_store_n(&w.shared->failed, 1, __ATOMIC_RELAXED);
+        }
+    }
+    if (err != 0 || failed) goto fail;
+
+    for (int i = 0; i < grid->nrow; i += 1)
+        memcpy(grid_row(grid, i), w.result + (size_t)i * nword,
+               sizeof(uint64_t) * nword);
+    board_touch(board);
+    board->generation += ngen;
+    munmap(map, size);
+    free(pairs);
+    return 0;
+
+fail:
+    if (err == 0 && !failed) err = errno;
+    for (int k = 0; pairs != NULL && k + 1 < nproc; k += 1) {
+        if (pairs[k][0] >= 0) close(pairs[k][0]);
+        if (pairs[k][1] >= 0) close(pairs[k][1]);
+    }
+    if (map != MAP_FAILED) munmap(map, size);
+    free(pairs);
+    errno = err;
+    return -1;
+}
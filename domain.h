@@ -0,0 +1,54 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 Multi-process domain decomposition		<domain.h>
+///
+
+#ifndef DOMAIN_H
+#define DOMAIN_H
+
+#include <stdint.h>
+
+#include "grid.h"
+
+// —————————————————————————————————————————————————————————————————————————————
+// DOMAIN DECOMPOSITION.
+//
+// Splits the board into `nproc` stripes of whole rows, each stepped by a
+// worker process of its own. Rows are packed into words, so stripes only
+// trade rows: every generation a worker hands its first and last row to
+// the workers above and below, and takes theirs into its grid's pad rows,
+// a one-row halo. It steps the rows in between first, which need no halo,
+// so the exchange overlaps with most of the work.
+//
+// Halos travel through one POSIX shared memory object, in two slots per
+// edge used on alternate generations and a generation counter per worker,
+// or through Unix socket pairs between neighbours, which stand in for a
+// network. Each worker is pinned to the CPUs of one NUMA node in turn and
+// allocates its stripe after that, so its cells live on that node. The
+// stepping is `update_state_rows` on the same cells and halo, so the board
+// comes out the same as stepped in one process.
+enum Halo_Transport {
+    HALO_SHM,
+    HALO_SOCKET,
+};
+
+struct Domain_Config {
+    int                 nproc;
+    enum Halo_Transport transport;
+};
+
+// Advance `board`, which must have dead edges, `ngen` generations on worker
+// processes. Returns 0, or -1: with errno set if the workers could not be
+// started, or errno 0 if one of them failed.
+int domain_run(struct Board *board, uint64_t ngen,
+               const struct Domain_Config *config);
+
+#endif  // DOMAIN_H
@@ -0,0 +1,213 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 Streaming GIF encoder		<gif.c>
+///
+
+#include "gif.h"
+#include "profile.h"
+
+#include <string.h>
+
+#define GIF_MIN_CODE_SIZE 2  // Smallest the format allows, 2 colours used.
+#define GIF_CLEAR_CODE    (1 << GIF_MIN_CODE_SIZE)
+#define GIF_EOI_CODE      (GIF_CLEAR_CODE + 1)
+#define GIF_MAX_CODE_SIZE 12
+
+// Global palette: `CELL_DEAD` then `CELL_ALIVE`, as in the SDL renderer.
+static const uint8_t gif_palette[6] = {0, 0, 0, 170, 170, 0};
+
+// —————————————————————————————————————————————————————————————————————————————
+// BUFFERED OUTPUT.
+
+static void gif_flush(struct Gif_Writer *gif) {
+    if (gif->out_len > 0 &&
+        fwrite(gif->out, 1, gif->out_len, gif->file) != gif->out_len)
+        gif->error = 1;
+    gif->out_len = 0;
+}
+
+static void gif_put(struct Gif_Writer *gif, const uint8_t *data, size_t size) {
+    if (gif->out_len + size > sizeof(gif->out)) gif_flush(gif);
+    memcpy(gif->out + gif->out_len, data, size);
+    gif->out_len += size;
+}
+
+static void gif_put_u16(struct Gif_Writer *gif, int value) {
+    uint8_t bytes[2] = {value & 0xFF, (value >> 8) & 0xFF};
+    gif_put(gif, bytes, 2);
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// LZW CODE STREAM.
+//
+// Codes are packed LSB first into data sub-blocks of up to 255 bytes, each
+// preceded by its length. `block[0]` holds the length of the one being
+// filled.
+
+static void gif_put_code(struct Gif_Writer *gif, int code, int code_size) {
+    gif->bit_acc |= (uint32_t)code << gif->bit_len;
+    gif->bit_len += code_size;
+    while (gif->bit_len >= 8) {
+        gif->block[1 + gif->block[0]++] = gif->bit_acc & 0xFF;
+        gif->bit_acc >>= 8;
+        gif->bit_len -= 8;
+        if (gif->block[0] == 255) {
+            gif_put(gif, gif->block, 256);
+            gif->block[0] = 0;
+        }
+    }
+}
+
+static void gif_end_codes(struct Gif_Writer *gif) {
+    if (gif->bit_len > 0) gif_put_code(gif, 0, 8 - gif->bit_len);
+    if (gif->block[0] > 0) gif_put(gif, gif->block, 1 + gif->block[0]);
+    gif->block[0] = 0;
+    gif_put(gif, (const uint8_t[]){0x00}, 1);  // Block terminator.
+}
+
+// Compress the rectangle [top, top + h) x [left, left + w) of `grid`.
+static void gif_encode_rect(struct Gif_Writer *gif, const struct Grid *grid,
+                            int top, int left, int h, int w) {
+    int code_size = GIF_MIN_CODE_SIZE + 1;
+    int next_code = GIF_EOI_CODE + 1;
+    int cur       = -1;  // Code of the string matched so far.
+
+    memset(gif->child, 0, sizeof(gif->child));
+    gif_put_code(gif, GIF_CLEAR_CODE, code_size);
+    for (int i = top; i < top + h; i += 1) {
+        const uint64_t *row = grid_row(grid, i);
+
+        for (int j = left; j < left + w; j += 1) {
+            int pixel = (row[j >> 6] >> (j & 63)) & 1;
+
+            if (cur < 0) {
+                cur = pixel;
+            } else if (gif->child[cur][pixel] != 0) {
+                cur = gif->child[cur][pixel];
+            } else {
+                gif_put_code(gif, cur, code_size);
+                gif->child[cur][pixel] = next_code++;
+                // The decoder adds its entry one code later, so widen
+                // once the code just added no longer fits.
+                if (next_code > (1 << code_size) &&
+                    code_size < GIF_MAX_CODE_SIZE)
+                    code_size += 1;
+                if (next_code == GIF_LZW_MAX_CODES) {  // Table full.
+                    gif_put_code(gif, GIF_CLEAR_CODE, code_size);
+                    memset(gif->child, 0, sizeof(gif->child));
+                    code_size = GIF_MIN_CODE_SIZE + 1;
+                    next_code = GIF_EOI_CODE + 1;
+                }
+                cur = pixel;
+            }
+        }
+    }
+    gif_put_code(gif, cur, code_size);
+    gif_put_code(gif, GIF_EOI_CODE, code_size);
+    gif_end_codes(gif);
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// FRAMES.
+
+int gif_open(struct Gif_Writer *gif, const char *path, int height, int width,
+             int delay_cs) {
+    if (width > 0xFFFF || height > 0xFFFF) return -1;  // Format limit.
+    gif->file     = fopen(path, "wb");
+    gif->width    = width;
+    gif->height   = height;
+    gif->delay_cs = delay_cs;
+    gif->nframe   = 0;
+    gif->bit_acc  = 0;
+    gif->bit_len  = 0;
+    gif->block[0] = 0;
+    gif->out_len  = 0;
+    gif->error    = 0;
+    if (gif->file == NULL) return -1;
+    if (grid_init(&gif->prev, height, width) != 0) {
+        fclose(gif->file);
+        return -1;
+    }
+    // Header, logical screen with a 2 entry global colour table, and the
+    // NETSCAPE2.0 extension asking viewers to loop forever.
+    static const uint8_t netscape[19] = {
+        0x21, 0xFF, 0x0B, 'N', 'E', 'T', 'S', 'C', 'A', 'P',
+        'E',  '2',  '.',  '0', 3,   1,   0,   0,   0};
+    gif_put(gif, (const uint8_t *)"GIF89a", 6);
+    gif_put_u16(gif, width);
+    gif_put_u16(gif, height);
+    gif_put(gif, (const uint8_t[]){0x80, 0x00, 0x00}, 3);
+    gif_put(gif, gif_palette, sizeof(gif_palette));
+    gif_put(gif, netscape, sizeof(netscape));
+
+    return 0;
+}
+
+// Bounding box of the cells that differ between `a` and `b`. Returns 0 if
+// there are none.
+static int gif_diff_box(const struct Grid *a, const struct Grid *b, int *top,
+                        int *left, int *bottom, int *right) {
+    *top   = -1;
+    *left  = a->ncol;
+    *right = -1;
+    for (int i = 0; i < a->nrow; i += 1) {
+        const uint64_t *ra = grid_row(a, i), *rb = grid_row(b, i);
+
+        for (int w = 0; w < a->nword; w += 1) {
+            uint64_t diff = ra[w] ^ rb[w];
+
+            if (diff == 0) continue;
+            int lo = 64 * w + __builtin_ctzll(diff);
+            int hi = 64 * w + 63 - __builtin_clzll(diff);
+
+            if (*top < 0) *top = i;
+            *bottom = i;
+            if (lo < *left) *left = lo;
+            if (hi > *right) *right = hi;
+        }
+    }
+    return *top >= 0;
+}
+
+int gif_add_frame(struct Gif_Writer *gif, const struct Grid *grid) {
+    int top = 0, left = 0, bottom = gif->height - 1, right = gif->width - 1;
+
+    if (gif->nframe > 0 &&
+        !gif_diff_box(&gif->prev, grid, &top, &left, &bottom, &right)) {
+        top = left = bottom = right = 0;  // Still needs a frame for the delay.
+    }
+    // Graphic control extension: keep the previous frame under this one.
+    gif_put(gif, (const uint8_t[]){0x21, 0xF9, 0x04, 0x04}, 4);
+    gif_put_u16(gif, gif->delay_cs);
+    gif_put(gif, (const uint8_t[]){0x00, 0x00}, 2);
+    // Image descriptor of the changed rectangle, no local colour table.
+    gif_put(gif, (const uint8_t[]){0x2C}, 1);
+    gif_put_u16(gif, left);
+    gif_put_u16(gif, top);
+    gif_put_u16(gif, right - left + 1);
+    gif_put_u16(gif, bottom - top + 1);
+    gif_put(gif, (const uint8_t[]){0x00, GIF_MIN_CODE_SIZE}, 2);
+    gif_encode_rect(gif, grid, top, left, bottom - top + 1, right - left + 1);
+    grid_copy(&gif->prev, grid);
+    gif->nframe += 1;
+    PROBE1(gif_frame, gif->nframe);
+
+    return gif->error ? -1 : 0;
+}
+
+int gif_close(struct Gif_Writer *gif) {
+    gif_put(gif, (const uint8_t[]){0x3B}, 1);  // Trailer.
+    gif_flush(gif);
+    if (fclose(gif->file) != 0) gif->error = 1;
+    grid_free(&gif->prev);
+
+    return gif->error ? -1 : 0;
+}
@@ -0,0 +1,56 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 Streaming GIF encoder		<gif.h>
+///
+
+#ifndef GIF_H
+#define GIF_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "grid.h"
+
+// —————————————————————————————————————————————————————————————————————————————
+// GIF WRITER.
+//
+// Writes an animated GIF89a one generation at a time, one pixel per cell in
+// a 2-colour global palette. Each frame is LZW-compressed and only covers
+// the bounding box of the cells that changed since the previous frame; the
+// rest of the picture is left in place. Memory use is fixed by the board
+// size: the previous frame as a bit grid, plus a few small buffers.
+#define GIF_LZW_MAX_CODES 4096
+#define GIF_OUT_SIZE      (1 << 16)
+
+struct Gif_Writer {
+    FILE       *file;
+    int         width, height;
+    int         delay_cs;                    // per frame, in 1/100 s.
+    int         nframe;
+    struct Grid prev;                        // last frame written.
+    uint16_t    child[GIF_LZW_MAX_CODES][2]; // LZW trie: code + pixel.
+    uint32_t    bit_acc;                     // pending code bits, LSB first.
+    int         bit_len;
+    uint8_t     block[256];                  // data sub-block, len first.
+    size_t      out_len;
+    uint8_t     out[GIF_OUT_SIZE];           // buffered file output.
+    int         error;                       // a write failed.
+};
+
+// Create `path` for a `height` x `width` animation. Returns 0 on success.
+int gif_open(struct Gif_Writer *gif, const char *path, int height, int width,
+             int delay_cs);
+// Append `grid`, which must be `height` x `width`, as the next frame.
+int gif_add_frame(struct Gif_Writer *gif, const struct Grid *grid);
+// Write the trailer and close the file. Returns 0 if every write succeeded.
+int gif_close(struct Gif_Writer *gif);
+
+#endif  // GIF_H
@@ -0,0 +1,722 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 Bit-packed grid engine		<grid.c>
+///
+
+#include "grid.h"
+#include "pool.h"
+#include "profile.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define GRID_X86 1
+#endif
+
+#define STRIPES_PER_THREAD 4   // Spare stripes to steal when rows are uneven.
+#define CHUNK_TILES        16  // Tiles stepped together along a run.
+
+static void                      select_kernel(void);
+static const struct Rule_Kernel *find_kernel(struct Rule rule);
+
+// —————————————————————————————————————————————————————————————————————————————
+// GRID STORAGE.
+
+// Fill in the dimensions of a grid whose storage starts at `cells`.
+static void grid_layout(struct Grid *grid, int nrow, int ncol,
+                        uint64_t *cells) {
+    grid->nrow   = nrow;
+    grid->ncol   = ncol;
+    grid->nword  = (ncol + 63) / 64;
+    grid->stride = grid->nword + 2;
+    grid->cells  = cells;
+}
+
+size_t grid_size(int nrow, int ncol) {
+    size_t stride = (size_t)(ncol + 63) / 64 + 2;
+    size_t size   = (size_t)(nrow + 2) * stride * sizeof(uint64_t);
+
+    return (size + 63) & ~(size_t)63;  // aligned_alloc wants a multiple.
+}
+
+int grid_init(struct Grid *grid, int nrow, int ncol) {
+    size_t    size  = grid_size(nrow, ncol);
+    uint64_t *cells = aligned_alloc(64, size);
+
+    if (cells == NULL) return -1;
+    memset(cells, 0, size);
+    grid_layout(grid, nrow, ncol, cells);
+
+    return 0;
+}
+
+void grid_free(struct Grid *grid) {
+    free(grid->cells);
+    grid->cells = NULL;
+}
+
+void grid_copy(struct Grid *dst, const struct Grid *src) {
+    memcpy(dst->cells, src->cells,
+           (size_t)(src->nrow + 2) * src->stride * sizeof(uint64_t));
+}
+
+uint64_t grid_population(const struct Grid *grid) {
+    uint64_t count = 0;
+
+    for (int i = 0; i < grid->nrow; i += 1) {
+        const uint64_t *row = grid_row(grid, i);
+
+        for (int w = 0; w < grid->nword; w += 1) {
+            count += __builtin_popcountll(row[w]);
+        }
+    }
+    return count;
+}
+
+int grid_margin(const struct Grid *grid) {
+    int top = -1, bottom = -1, left = grid->ncol, right = -1;
+
+    for (int i = 0; i < grid->nrow; i += 1) {
+        const uint64_t *row = grid_row(grid, i);
+
+        for (int w = 0; w < grid->nword; w += 1) {
+            if (row[w] == 0) continue;
+            int lo = w * 64 + __builtin_ctzll(row[w]);
+            int hi = w * 64 + 63 - __builtin_clzll(row[w]);
+
+            if (top < 0) top = i;
+            bottom = i;
+            if (lo < left) left = lo;
+            if (hi > right) right = hi;
+        }
+    }
+    if (top < 0) return -1;
+
+    int margin = top < left ? top : left;
+    if (grid->nrow - 1 - bottom < margin) margin = grid->nrow - 1 - bottom;
+    if (grid->ncol - 1 - right < margin) margin = grid->ncol - 1 - right;
+    return margin;
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// HALO.
+
+void grid_fill_halo(struct Grid *grid, enum Topology topology) {
+    const int torus = topology == TOPOLOGY_TORUS;
+    const int last  = grid->ncol - 1;
+
+    if (topology == TOPOLOGY_DEAD) return;
+    for (int i = 0; i < grid->nrow; i += 1) {
+        uint64_t *row   = grid_row(grid, i);
+        uint64_t  left  = grid_get(grid, i, torus ? last : 0);
+        uint64_t  right = grid_get(grid, i, torus ? 0 : last);
+
+        // Column -1 is the top bit of the left pad word, and column `ncol`
+        // the first bit past the tail, which is in the right pad word when
+        // the last word is full.
+        row[-1]               = left << 63;
+        row[grid->ncol >> 6] |= right << (grid->ncol & 63);
+    }
+    // Then whole padded rows, so the corners come along.
+    const size_t bytes = sizeof(uint64_t) * grid->stride;
+    memcpy(grid_row(grid, -1) - 1,
+           grid_row(grid, torus ? grid->nrow - 1 : 0) - 1, bytes);
+    memcpy(grid_row(grid, grid->nrow) - 1,
+           grid_row(grid, torus ? 0 : grid->nrow - 1) - 1, bytes);
+}
+
+void grid_clear_halo(struct Grid *grid) {
+    const uint64_t tail  = grid_tail_mask(grid);
+    const size_t   bytes = sizeof(uint64_t) * grid->stride;
+
+    memset(grid_row(grid, -1) - 1, 0, bytes);
+    memset(grid_row(grid, grid->nrow) - 1, 0, bytes);
+    for (int i = 0; i < grid->nrow; i += 1) {
+        uint64_t *row = grid_row(grid, i);
+
+        row[-1]               = 0;
+        row[grid->nword - 1] &= tail;
+        row[grid->nword]      = 0;
+    }
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// BOARD STORAGE.
+
+int board_init(struct Board *board, int nrow, int ncol) {
+    size_t   size   = grid_size(nrow, ncol);
+    int      ntrow  = (nrow + TILE_ROWS - 1) / TILE_ROWS;
+    int      ntcol  = (ncol + TILE_COLS - 1) / TILE_COLS;
+    size_t   ntile  = (size_t)ntrow * ntcol;
+    size_t   bytes  = 2 * size + ((2 * ntile + 63) & ~(size_t)63);
+    uint8_t *arena;
+
+    if (nrow <= 0 || ncol <= 0) return -1;
+    select_kernel();  // For the board's own steps, which skip the check.
+    // Fresh anonymous pages are zero, pads included, and are only faulted
+    // in when touched, so a board that is about to be replaced by a mapped
+    // checkpoint costs next to nothing.
+    arena = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (arena == MAP_FAILED) return -1;
+    grid_layout(&board->front, nrow, ncol, (uint64_t *)arena);
+    grid_layout(&board->back, nrow, ncol, (uint64_t *)(arena + size));
+    board->arena       = arena;
+    board->arena_size  = bytes;
+    board->mapped      = NULL;
+    board->mapped_size = 0;
+    board->generation  = 0;
+    board->pool        = NULL;
+    board->rule        = RULE_CONWAY;
+    board->kernel      = find_kernel(RULE_CONWAY);
+    board->tile_hash   = NULL;
+    board->hash        = 0;
+    board->topology    = TOPOLOGY_DEAD;
+    board->tile_nrow  = ntrow;
+    board->tile_ncol  = ntcol;
+    board->dirty      = arena + 2 * size;
+    board->dirty_next = board->dirty + ntile;
+    // The back buffer does not hold the previous generation yet, so every
+    // tile has to be stepped at least once.
+    memset(board->dirty, 1, ntile);
+
+    return 0;
+}
+
+void board_free(struct Board *board) {
+    munmap(board->arena, board->arena_size);
+    if (board->mapped != NULL) munmap(board->mapped, board->mapped_size);
+    free(board->tile_hash);
+    board->tile_hash   = NULL;
+    board->arena       = NULL;
+    board->mapped      = NULL;
+    board->front.cells = NULL;
+    board->back.cells  = NULL;
+}
+
+void board_swap(struct Board *board) {
+    struct Grid tmp   = board->front;
+    uint8_t    *dirty = board->dirty;
+
+    board->front      = board->back;
+    board->back       = tmp;
+    board->dirty      = board->dirty_next;
+    board->dirty_next = dirty;
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// LIFE-LIKE RULES.
+
+int rule_parse(const char *text, struct Rule *rule) {
+    struct Rule parsed = {0, 0};
+    int         seen_b = 0, seen_s = 0;
+
+    for (const char *p = text; *p != '\0';) {
+        uint16_t *mask;
+
+        if (*p == 'B' || *p == 'b') {
+            mask    = &parsed.birth;
+            seen_b += 1;
+        } else if (*p == 'S' || *p == 's') {
+            mask    = &parsed.survive;
+            seen_s += 1;
+        } else {
+            return -1;
+        }
+        for (p += 1; *p >= '0' && *p <= '8'; p += 1) *mask |= 1 << (*p - '0');
+        if (*p == '/') {
+            p += 1;
+            if (*p == '\0') return -1;
+        } else if (*p != '\0') {
+            return -1;
+        }
+    }
+    if (seen_b != 1 || seen_s != 1) return -1;
+    *rule = parsed;
+
+    return 0;
+}
+
+void rule_table(struct Rule rule, uint8_t table[512]) {
+    for (int k = 0; k < 512; k += 1) {
+        int count = __builtin_popcount(k & ~0x10);
+
+        table[k] = ((k & 0x10 ? rule.survive : rule.birth) >> count) & 1;
+    }
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// STEP KERNELS.
+//
+// A row is stepped a whole word (or vector of words) at a time. The eight
+// neighbours of every bit are lined up by shifting the rows above, at and
+// below by one column, pulling the carried bit in from the adjacent word, and
+// the neighbour count is summed bit-parallel with full adders into four
+// binary digits. The rule then maps the count and the cell to its next state.
+//
+// The kernel body is written once against a word type `T` which is either a
+// plain `uint64_t` or a GCC vector of them, since both share the same bitwise
+// and shift operators, and against the rule's `BIRTH` and `SURVIVE` masks.
+// Given constant masks, the compiler folds the rule into the few gates that
+// rule needs; given the masks of a `struct Rule`, the same body makes the
+// generic kernel for any other rule. Each kernel returns how many words it
+// stepped, leaving any tail shorter than a vector to the scalar kernel. If
+// `changed` is given, the bits that flipped in word `w` are OR-ed into
+// `changed[w]`.
+
+#define LOAD_SHIFTED(T, row, w, x, xl, xr)                                     \
+    do {                                                                       \
+        T prev_, next_;                                                        \
+        memcpy(&x, (row) + (w), sizeof(T));                                    \
+        memcpy(&prev_, (row) + (w) - 1, sizeof(T));                            \
+        memcpy(&next_, (row) + (w) + 1, sizeof(T));                            \
+        xl = (x << 1) | (prev_ >> 63);  /* Neighbour at column j - 1. */      \
+        xr = (x >> 1) | (next_ << 63);  /* Neighbour at column j + 1. */      \
+    } while (0)
+
+// Cells whose count of neighbours is `n`, given the digits of the count.
+#define COUNT_IS(n, d0, d1, d2, d3)                                            \
+    (((n) & 1 ? d0 : ~d0) & ((n) & 2 ? d1 : ~d1) & ((n) & 4 ? d2 : ~d2) &     \
+     ((n) & 8 ? d3 : ~d3))
+
+// Cells with `n` neighbours that are alive next generation.
+#define RULE_TERM(n, BIRTH, SURVIVE, c, d0, d1, d2, d3)                        \
+    ((((BIRTH) | (SURVIVE)) >> (n) & 1)                                        \
+         ? COUNT_IS(n, d0, d1, d2, d3) &                                       \
+               ((BIRTH) >> (n) & 1 ? ((SURVIVE) >> (n) & 1 ? ~(c & 0) : ~c)   \
+                                   : c)                                        \
+         : (c & 0))
+
+#define DEFINE_ROW_KERNEL(NAME, T, LANES, ATTR, BIRTH, SURVIVE)                \
+    ATTR static int NAME(uint64_t *restrict dst, const uint64_t *up,           \
+                         const uint64_t *mid, const uint64_t *down, int nword, \
+                         uint64_t *restrict changed,                           \
+                         const struct Rule *rule) {                            \
+        (void)rule;                                                            \
+        int w = 0;                                                             \
+        for (; w + (LANES) <= nword; w += (LANES)) {                           \
+            T a, al, ar, c, cl, cr, b, bl, br, next;                           \
+            LOAD_SHIFTED(T, up, w, a, al, ar);                                 \
+            LOAD_SHIFTED(T, mid, w, c, cl, cr);                                \
+            LOAD_SHIFTED(T, down, w, b, bl, br);                               \
+            /* Column sums: 0..3 above and below, 0..2 beside. */             \
+            T sa = al ^ a ^ ar, ca = (al & a) | (ar & (al ^ a));               \
+            T sb = bl ^ b ^ br, cb = (bl & b) | (br & (bl ^ b));               \
+            T sc = cl ^ cr, cc = cl & cr;                                      \
+            /* Add the three 2-bit sums. */                                   \
+            T ones = sa ^ sb ^ sc;                                             \
+            T k1   = (sa & sb) | (sc & (sa ^ sb));                             \
+            T t0   = ca ^ cb ^ cc;                                             \
+            T t1   = (ca & cb) | (cc & (ca ^ cb));                             \
+            if ((BIRTH) == RULE_CONWAY.birth &&                                \
+                (SURVIVE) == RULE_CONWAY.survive) {                            \
+                /* Count 3, or 2 and alive: no need to tell 4 from 8. */      \
+                T twos  = t0 ^ k1;                                             \
+                T fours = t1 | (t0 & k1);                                      \
+                next    = ~fours & twos & (ones | c);                          \
+            } else {                                                           \
+                T d1 = t0 ^ k1, d2 = t1 ^ (t0 & k1), d3 = t1 & t0 & k1;        \
+                next = RULE_TERM(0, BIRTH, SURVIVE, c, ones, d1, d2, d3) |     \
+                       RULE_TERM(1, BIRTH, SURVIVE, c, ones, d1, d2, d3) |     \
+                       RULE_TERM(2, BIRTH, SURVIVE, c, ones, d1, d2, d3) |     \
+                       RULE_TERM(3, BIRTH, SURVIVE, c, ones, d1, d2, d3) |     \
+                       RULE_TERM(4, BIRTH, SURVIVE, c, ones, d1, d2, d3) |     \
+                       RULE_TERM(5, BIRTH, SURVIVE, c, ones, d1, d2, d3) |     \
+                       RULE_TERM(6, BIRTH, SURVIVE, c, ones, d1, d2, d3) |     \
+                       RULE_TERM(7, BIRTH, SURVIVE, c, ones, d1, d2, d3) |     \
+                       RULE_TERM(8, BIRTH, SURVIVE, c, ones, d1, d2, d3);      \
+            }                                                                  \
+            memcpy(dst + w, &next, sizeof(T));                                 \
+            if (changed != NULL) {                                             \
+                T flips;                                                       \
+                memcpy(&flips, changed + w, sizeof(T));                        \
+                flips |= next ^ c;                                             \
+                memcpy(changed + w, &flips, sizeof(T));                        \
+            }                                                                  \
+        }                                                                      \
+        return w;                                                              \
+    }
+
+// Rules that get kernels of their own: name, birth mask, survive mask.
+#define SPECIALISED_RULES(X)                                                   \
+    X(conway, 0x008, 0x00C)   /* B3/S23. */                                  \
+    X(highlife, 0x048, 0x00C) /* B36/S23. */                                 \
+    X(daynight, 0x1C8, 0x1D8) /* B3678/S34678. */                            \
+    X(seeds, 0x004, 0x000)    /* B2/S. */
+
+#ifdef GRID_X86
+typedef uint64_t u64x2 __attribute__((vector_size(16)));
+typedef uint64_t u64x4 __attribute__((vector_size(32)));
+
+    #define DEFINE_RULE_KERNELS(NAME, BIRTH, SURVIVE)                          \
+        DEFINE_ROW_KERNEL(step_row_##NAME##_scalar, uint64_t, 1, , BIRTH,      \
+                          SURVIVE)                                             \
+        DEFINE_ROW_KERNEL(step_row_##NAME##_sse2, u64x2, 2,                    \
+                          __attribute__((target("sse2"))), BIRTH, SURVIVE)     \
+        DEFINE_ROW_KERNEL(step_row_##NAME##_avx2, u64x4, 4,                    \
+                          __attribute__((target("avx2"))), BIRTH, SURVIVE)
+    #define RULE_KERNEL_ENTRY(NAME, BIRTH, SURVIVE)                            \
+        {{BIRTH, SURVIVE},                                                     \
+         #NAME,                                                                \
+         {step_row_##NAME##_scalar, step_row_##NAME##_sse2,                    \
+          step_row_##NAME##_avx2}},
+#else
+    #define DEFINE_RULE_KERNELS(NAME, BIRTH, SURVIVE)                          \
+        DEFINE_ROW_KERNEL(step_row_##NAME##_scalar, uint64_t, 1, , BIRTH,      \
+                          SURVIVE)
+    #define RULE_KERNEL_ENTRY(NAME, BIRTH, SURVIVE)                            \
+        {{BIRTH, SURVIVE},                                                     \
+         #NAME,                                                                \
+         {step_row_##NAME##_scalar, step_row_##NAME##_scalar,                  \
+          step_row_##NAME##_scalar}},
+#endif
+
+SPECIALISED_RULES(DEFINE_RULE_KERNELS)
+DEFINE_RULE_KERNELS(generic, rule->birth, rule->survive)
+
+typedef int (*Row_Kernel)(uint64_t *restrict, const uint64_t *,
+                          const uint64_t *, const uint64_t *, int,
+                          uint64_t *restrict, const struct Rule *);
+
+enum Cpu_Level { CPU_SCALAR, CPU_SSE2, CPU_AVX2, CPU_LEVELS };
+
+struct Rule_Kernel {
+    struct Rule rule;  // Unused by the generic kernel, which is last.
+    const char *name;
+    Row_Kernel  step_row[CPU_LEVELS];
+};
+
+static const struct Rule_Kernel rule_kernels[] = {
+    SPECIALISED_RULES(RULE_KERNEL_ENTRY)
+    RULE_KERNEL_ENTRY(generic, 0, 0)
+};
+
+#define RULE_KERNEL_COUNT (sizeof(rule_kernels) / sizeof(rule_kernels[0]))
+
+static int            cpu_level     = -1;
+static pthread_once_t cpu_level_once = PTHREAD_ONCE_INIT;
+static const char    *cpu_level_name[CPU_LEVELS] = {"scalar", "sse2", "avx2"};
+
+static void detect_cpu_level(void) {
+    cpu_level = CPU_SCALAR;
+#ifdef GRID_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        cpu_level = CPU_AVX2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        cpu_level = CPU_SSE2;
+    }
+#endif
+}
+
+// Pick the widest kernels the running CPU supports, once, whichever thread
+// gets here first.
+static void select_kernel(void) {
+    pthread_once(&cpu_level_once, detect_cpu_level);
+}
+
+const char *grid_kernel_name(void) {
+    select_kernel();
+    return cpu_level_name[cpu_level];
+}
+
+// The kernels specialised for `rule`, or the generic ones.
+static const struct Rule_Kernel *find_kernel(struct Rule rule) {
+    for (size_t k = 0; k + 1 < RULE_KERNEL_COUNT; k += 1) {
+        if (rule_kernels[k].rule.birth == rule.birth &&
+            rule_kernels[k].rule.survive == rule.survive)
+            return &rule_kernels[k];
+    }
+    return &rule_kernels[RULE_KERNEL_COUNT - 1];
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// GAME LOGIC.
+
+// Update game of life state. Cells beyond the grid's edges count as dead.
+void update_state(struct Grid *new_grid, const struct Grid *grid,
+                  struct Rule rule) {
+    update_state_rows(new_grid, grid, rule, 0, grid->nrow);
+}
+
+// Step words [w_begin, w_end) of row `i`, OR-ing flipped bits into
+// `changed[0 .. w_end - w_begin)` unless it is NULL.
+static void step_span(struct Grid *new_grid, const struct Grid *grid,
+                      const struct Rule_Kernel *kernel,
+                      const struct Rule *rule, int i, int w_begin, int w_end,
+                      uint64_t *changed) {
+    uint64_t       *dst  = grid_row(new_grid, i) + w_begin;
+    const uint64_t *up   = grid_row(grid, i - 1) + w_begin;
+    const uint64_t *mid  = grid_row(grid, i) + w_begin;
+    const uint64_t *down = grid_row(grid, i + 1) + w_begin;
+    int             n    = w_end - w_begin;
+    int w = kernel->step_row[cpu_level](dst, up, mid, down, n, changed, rule);
+
+    if (w < n) {  // Finish the tail a vector did not cover.
+        kernel->step_row[CPU_SCALAR](dst + w, up + w, mid + w, down + w, n - w,
+                                     changed ? changed + w : NULL, rule);
+    }
+    if (w_end == grid->nword) {  // Keep bits past the last column dead.
+        uint64_t tail = grid_tail_mask(grid);
+
+        if (changed != NULL) changed[n - 1] &= tail;
+        dst[n - 1] &= tail;
+    }
+}
+
+void update_state_rows(struct Grid *new_grid, const struct Grid *grid,
+                       struct Rule rule, int row_begin, int row_end) {
+    const struct Rule_Kernel *kernel = find_kernel(rule);
+
+    select_kernel();
+    for (int i = row_begin; i < row_end; i += 1) {
+        step_span(new_grid, grid, kernel, &rule, i, 0, grid->nword, NULL);
+    }
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// ACTIVE TILES.
+//
+// A tile can only change if something in it or in one of its eight
+// neighbours changed in the previous generation. Otherwise its next state is
+// its current state, and the back buffer already holds exactly that (it is
+// the previous generation, which the tile matched), so it is skipped.
+
+static int tile_active(const struct Board *board, int trow, int tcol) {
+    const int wrap = board->topology == TOPOLOGY_TORUS;
+
+    for (int r = trow - 1; r <= trow + 1; r += 1) {
+        int rr = r;
+
+        if (rr < 0 || rr >= board->tile_nrow) {
+            if (!wrap) continue;
+            rr = (rr + board->tile_nrow) % board->tile_nrow;
+        }
+        for (int c = tcol - 1; c <= tcol + 1; c += 1) {
+            int cc = c;
+
+            if (cc < 0 || cc >= board->tile_ncol) {
+                if (!wrap) continue;
+                cc = (cc + board->tile_ncol) % board->tile_ncol;
+            }
+            if (board->dirty[rr * board->tile_ncol + cc]) return 1;
+        }
+    }
+    return 0;
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// BOARD HASH.
+
+// Hash of the tile of `grid` at (trow, tcol). Every word is mixed with its
+// position, and words of dead cells add nothing, so the hashes of distinct
+// tiles can be XOR-ed together and an empty board hashes to 0.
+static uint64_t tile_hash(const struct Grid *grid, int trow, int tcol) {
+    const int w_begin = tcol * TILE_WORDS;
+    const int w_end   = w_begin + TILE_WORDS < grid->nword ? w_begin + TILE_WORDS
+                                                           : grid->nword;
+    const int i_end   = (trow + 1) * TILE_ROWS < grid->nrow
+                            ? (trow + 1) * TILE_ROWS
+                            : grid->nrow;
+    uint64_t  hash    = 0;
+
+    for (int i = trow * TILE_ROWS; i < i_end; i += 1) {
+        const uint64_t *row = grid_row(grid, i);
+
+        for (int w = w_begin; w < w_end; w += 1) {
+            uint64_t h = row[w] ^ ((uint64_t)i << 32 | (uint32_t)w) *
+                                      0x9E3779B97F4A7C15ull;
+            h ^= h >> 31;  // splitmix64's finaliser.
+            h *= 0xBF58476D1CE4E5B9ull;
+            h ^= h >> 27;
+            h *= 0x94D049BB133111EBull;
+            h ^= h >> 31;
+            hash ^= row[w] != 0 ? h : 0;
+        }
+    }
+    return hash;
+}
+
+// Rehash every tile of `front`.
+static void board_rehash(struct Board *board) {
+    board->hash = 0;
+    for (int trow = 0; trow < board->tile_nrow; trow += 1) {
+        for (int tcol = 0; tcol < board->tile_ncol; tcol += 1) {
+            uint64_t h = tile_hash(&board->front, trow, tcol);
+
+            board->tile_hash[trow * board->tile_ncol + tcol] = h;
+            board->hash ^= h;
+        }
+    }
+}
+
+int board_track_hash(struct Board *board) {
+    if (board->tile_hash != NULL) return 0;
+    board->tile_hash =
+        malloc(sizeof(uint64_t) * board->tile_nrow * board->tile_ncol);
+    if (board->tile_hash == NULL) return -1;
+    board_rehash(board);
+    return 0;
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// STEPPING TILES.
+
+// Step the active tiles of one tile row and flag those that changed. Runs
+// of adjacent active tiles go to the kernel together so vectors stay full.
+static void step_tile_row(struct Board *board, int trow) {
+    const struct Grid *grid      = &board->front;
+    struct Grid       *new_grid  = &board->back;
+    uint8_t           *dirty     = board->dirty_next + trow * board->tile_ncol;
+    int                row_begin = trow * TILE_ROWS;
+    int                row_end   = row_begin + TILE_ROWS;
+
+    uint64_t           hash_delta = 0;
+
+    if (row_end > grid->nrow) row_end = grid->nrow;
+    for (int tcol = 0; tcol < board->tile_ncol;) {
+        int run_end = tcol;
+
+        while (run_end < board->tile_ncol && tile_active(board, trow, run_end))
+            run_end += 1;
+        if (run_end == tcol) {  // Idle tile: untouched, hence unchanged.
+            dirty[tcol] = 0;
+            tcol += 1;
+            continue;
+        }
+        // Step the run a few tiles at a time, so the flipped bits of every
+        // column of words in it fit in `changed` on the stack.
+        while (tcol < run_end) {
+            int      tend    = tcol + CHUNK_TILES < run_end ? tcol + CHUNK_TILES
+                                                            : run_end;
+            int      w_begin = tcol * TILE_WORDS, w_end = tend * TILE_WORDS;
+            uint64_t changed[CHUNK_TILES * TILE_WORDS] = {0};
+
+            if (w_end > grid->nword) w_end = grid->nword;
+            for (int i = row_begin; i < row_end; i += 1) {
+                step_span(new_grid, grid, board->kernel, &board->rule, i,
+                          w_begin, w_end, changed);
+            }
+            for (int t = tcol; t < tend; t += 1) {
+                uint64_t flips = 0;
+
+                for (int k = 0; k < TILE_WORDS; k += 1) {
+                    flips |= changed[(t - tcol) * TILE_WORDS + k];
+                }
+                dirty[t] = flips != 0;
+                if (flips != 0 && board->tile_hash != NULL) {
+                    uint64_t *h = &board->tile_hash[trow * board->tile_ncol + t];
+                    uint64_t old = *h;
+
+                    *h          = tile_hash(new_grid, trow, t);
+                    hash_delta ^= old ^ *h;
+                }
+            }
+            tcol = tend;
+        }
+    }
+    // Stripes on other threads fold in their own tile rows.
+    if (hash_delta != 0)
+        __atomic_fetch_xor(&board->hash, hash_delta, __ATOMIC_RELAXED);
+}
+
+void board_touch(struct Board *board) {
+    memset(board->dirty, 1, (size_t)board->tile_nrow * board->tile_ncol);
+    if (board->tile_hash != NULL) board_rehash(board);
+}
+
+void board_set_rule(struct Board *board, struct Rule rule) {
+    board->rule   = rule;
+    board->kernel = find_kernel(rule);
+}
+
+void board_map_front(struct Board *board, void *mapping, size_t size,
+                     uint64_t *cells) {
+    board->mapped      = mapping;
+    board->mapped_size = size;
+    board->front.cells = cells;
+    board_touch(board);
+}
+
+struct Stripe_Job {
+    struct Board *board;
+    int           tile_rows_per_stripe;
+};
+
+static void step_stripe(void *ctx, int stripe) {
+    struct Stripe_Job *job   = ctx;
+    int                begin = stripe * job->tile_rows_per_stripe;
+    int                end   = begin + job->tile_rows_per_stripe;
+
+    if (end > job->board->tile_nrow) end = job->board->tile_nrow;
+    for (int trow = begin; trow < end; trow += 1) {
+        step_tile_row(job->board, trow);
+    }
+}
+
+// Advance the board one generation, in stripes of whole tile rows when a
+// pool is attached.
+void board_step(struct Board *board) {
+    PROBE1(step_start, board->generation);
+    grid_fill_halo(&board->front, board->topology);
+    if (board->pool != NULL && pool_size(board->pool) > 1) {
+        int               want = pool_size(board->pool) * STRIPES_PER_THREAD;
+        struct Stripe_Job job  = {board, (board->tile_nrow + want - 1) / want};
+
+        pool_run(board->pool,
+                 (board->tile_nrow + job.tile_rows_per_stripe - 1) /
+                     job.tile_rows_per_stripe,
+                 step_stripe, &job);
+    } else {
+        for (int trow = 0; trow < board->tile_nrow; trow += 1) {
+            step_tile_row(board, trow);
+        }
+    }
+    if (board->topology != TOPOLOGY_DEAD) grid_clear_halo(&board->front);
+    board_swap(board);
+    board->generation += 1;
+    PROBE1(step_done, board->generation);
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// CYCLE DETECTION.
+
+int cycle_init(struct Cycle_Finder *finder, int max_period) {
+    finder->ring       = malloc(sizeof(uint64_t) * max_period);
+    finder->max_period = max_period;
+    finder->count      = 0;
+    return finder->ring != NULL ? 0 : -1;
+}
+
+void cycle_free(struct Cycle_Finder *finder) {
+    free(finder->ring);
+    finder->ring = NULL;
+}
+
+int cycle_push(struct Cycle_Finder *finder, uint64_t hash) {
+    const int n      = finder->max_period;
+    const int slot   = (int)(finder->count % n);
+    int       period = 0;
+
+    // Slot `slot - p` holds the hash of p generations back.
+    for (int p = 1; p <= n && (uint64_t)p <= finder->count; p += 1) {
+        if (finder->ring[(slot - p + n) % n] == hash) {
+            period = p;
+            break;
+        }
+    }
+    finder->ring[slot] = hash;
+    finder->count     += 1;
+    return period;
+}
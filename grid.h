@@ -0,0 +1,204 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 Bit-packed grid engine		<grid.h>
+///
+
+#ifndef GRID_H
+#define GRID_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// —————————————————————————————————————————————————————————————————————————————
+// BIT-PACKED GRID.
+//
+// Each cell is one bit: column `j` of a row lives in bit `j % 64` of word
+// `j / 64`. Rows carry one zero pad word on either side and the grid carries
+// one zero pad row above and below, so the step kernels can read the 3x3
+// neighbourhood of any cell without a bounds check.
+struct Grid {
+    int       nrow;    // height visually.
+    int       ncol;    // width visually.
+    int       nword;   // words holding the cells of one row.
+    int       stride;  // words per padded row (nword + 2).
+    uint64_t *cells;   // (nrow + 2) * stride words, pads included.
+};
+
+// Allocate a zeroed (all `CELL_DEAD`) grid. Returns 0 on success.
+int    grid_init(struct Grid *grid, int nrow, int ncol);
+void   grid_free(struct Grid *grid);
+void   grid_copy(struct Grid *dst, const struct Grid *src);
+size_t grid_size(int nrow, int ncol);  // Padded bytes, a multiple of 64.
+// Number of live cells.
+uint64_t grid_population(const struct Grid *grid);
+// Fewest dead cells between a live cell and the nearest edge, or -1 if no
+// cell is alive.
+int grid_margin(const struct Grid *grid);
+
+// —————————————————————————————————————————————————————————————————————————————
+// LIFE-LIKE RULES.
+//
+// In rule "Bxxx/Syyy" a dead cell with a neighbour count listed after B is
+// born, and a live one with a count listed after S survives. Bit n of each
+// mask stands for a count of n. Conway's Life is B3/S23.
+struct Rule {
+    uint16_t birth;
+    uint16_t survive;
+};
+
+#define RULE_CONWAY ((struct Rule){1 << 3, 1 << 2 | 1 << 3})
+
+// Parse "B36/S23" (case-insensitive, either half may come first). Returns 0,
+// or -1 if `text` is not a rule.
+int rule_parse(const char *text, struct Rule *rule);
+// Fill the next state of the centre cell for each 3x3 neighbourhood, whose
+// cell (r, c) is bit 3 * r + c of the index, so the centre is bit 4.
+void rule_table(struct Rule rule, uint8_t table[512]);
+
+// —————————————————————————————————————————————————————————————————————————————
+// TOPOLOGY.
+//
+// What lies past the edges. The pad words and rows around the cells double
+// as a one-cell halo: `grid_fill_halo` writes the cells the topology puts
+// just outside the grid into them, so the kernels read the neighbours of
+// edge cells like any other, and `grid_clear_halo` zeroes them again.
+enum Topology {
+    TOPOLOGY_DEAD,    // dead cells all round.
+    TOPOLOGY_TORUS,   // the opposite edge wraps round.
+    TOPOLOGY_MIRROR,  // each edge cell is reflected back at itself.
+};
+
+void grid_fill_halo(struct Grid *grid, enum Topology topology);
+void grid_clear_halo(struct Grid *grid);
+
+// Name of the step kernel picked for this CPU, e.g. "avx2".
+const char *grid_kernel_name(void);
+
+// Advance `grid` by one generation of `rule` into `new_grid` (same
+// dimensions), reading whatever halo `grid` has.
+void update_state(struct Grid *new_grid, const struct Grid *grid,
+                  struct Rule rule);
+// Same, for rows [row_begin, row_end) of `new_grid` only.
+void update_state_rows(struct Grid *new_grid, const struct Grid *grid,
+                       struct Rule rule, int row_begin, int row_end);
+
+// —————————————————————————————————————————————————————————————————————————————
+// DOUBLE-BUFFERED BOARD.
+//
+// Both generations live in one 64-byte aligned arena. A step writes the next
+// generation into `back` and swaps the two grids, so no cells are copied.
+//
+// The board is also cut into tiles of TILE_ROWS x TILE_COLS cells, and a
+// step only recomputes tiles that changed last generation or border one
+// that did. `dirty` flags the tiles changed by the last step, which is also
+// what a renderer needs to redraw.
+//
+// Once `board_track_hash` is called, the board also keeps a 64-bit hash of
+// `front`. It is the XOR of one hash per tile, and a step only rehashes the
+// tiles it changed, so keeping it costs next to nothing once the board has
+// mostly settled. An empty board hashes to 0.
+//
+// Each step fills the halo of `front` for `topology` first, and a torus
+// also wraps the tiles whose changes can reach a tile across its edges.
+//
+// With a `pool` attached the step is cut into row stripes run in parallel.
+// Stripes only read `front`, which is frozen for the step, so the rows just
+// outside a stripe serve as its halo without being copied anywhere.
+#define TILE_ROWS  16
+#define TILE_WORDS 4
+#define TILE_COLS  (64 * TILE_WORDS)
+
+struct Pool;
+struct Rule_Kernel;
+
+struct Board {
+    struct Grid  front;       // current generation.
+    struct Grid  back;        // next generation, scratch until the swap.
+    void        *arena;
+    size_t       arena_size;
+    void        *mapped;      // file mapping one grid may live in, or NULL.
+    size_t       mapped_size;
+    struct Pool *pool;        // NULL steps on the calling thread.
+    int          tile_nrow;   // tiles down.
+    int          tile_ncol;   // tiles across.
+    uint8_t     *dirty;       // tile_nrow * tile_ncol flags, last step.
+    uint8_t     *dirty_next;  // flags being written by the current step.
+    uint64_t     generation;  // steps taken since the seed.
+    struct Rule  rule;        // RULE_CONWAY unless set.
+    const struct Rule_Kernel *kernel;  // specialised for `rule` if possible.
+    enum Topology topology;   // TOPOLOGY_DEAD unless set.
+    uint64_t    *tile_hash;   // per tile of `front`, or NULL if not tracked.
+    uint64_t     hash;        // of `front`: XOR of `tile_hash`.
+};
+
+int  board_init(struct Board *board, int nrow, int ncol);
+void board_free(struct Board *board);
+void board_swap(struct Board *board);
+void board_step(struct Board *board);
+// Switch the rule later steps follow, and the kernel that runs it.
+void board_set_rule(struct Board *board, struct Rule rule);
+// Start keeping `hash` up to date. Returns 0, or -1 if out of memory.
+int  board_track_hash(struct Board *board);
+// Flag every tile dirty after `front` was rewritten behind the board's back.
+void board_touch(struct Board *board);
+// Make `cells`, inside the writable private file mapping [mapping, +size),
+// the front grid of a board not stepped yet. The mapping is then the
+// board's to unmap, and later steps write into it like any other buffer.
+void board_map_front(struct Board *board, void *mapping, size_t size,
+                     uint64_t *cells);
+
+static inline int board_tile_dirty(const struct Board *board, int trow,
+                                   int tcol) {
+    return board->dirty[trow * board->tile_ncol + tcol];
+}
+
+// Word 0 of row `i`, where `i` may be -1 or `nrow` to reach the pad rows.
+static inline uint64_t *grid_row(const struct Grid *grid, int i) {
+    return grid->cells + (size_t)(i + 1) * grid->stride + 1;
+}
+
+static inline int grid_get(const struct Grid *grid, int i, int j) {
+    return (int)((grid_row(grid, i)[j >> 6] >> (j & 63)) & 1);
+}
+
+static inline void grid_set(struct Grid *grid, int i, int j, int cell) {
+    uint64_t *word = &grid_row(grid, i)[j >> 6];
+    uint64_t  bit  = (uint64_t)1 << (j & 63);
+
+    *word = cell ? (*word | bit) : (*word & ~bit);
+}
+
+// Mask of the bits in a row's last word that hold real cells.
+static inline uint64_t grid_tail_mask(const struct Grid *grid) {
+    return (grid->ncol & 63) ? ((uint64_t)1 << (grid->ncol & 63)) - 1
+                             : ~(uint64_t)0;
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// CYCLE DETECTION.
+//
+// A ring of the last `max_period` board hashes. A board whose hash matches
+// the one p generations back has (barring a 64-bit collision) entered a
+// cycle of period p, and will repeat those p generations forever: a still
+// life or a dead board has period 1.
+struct Cycle_Finder {
+    uint64_t *ring;
+    int       max_period;
+    uint64_t  count;  // hashes pushed.
+};
+
+int  cycle_init(struct Cycle_Finder *finder, int max_period);
+void cycle_free(struct Cycle_Finder *finder);
+// Record the hash of the next generation. Returns the shortest period it
+// closes, or 0 if none.
+int cycle_push(struct Cycle_Finder *finder, uint64_t hash);
+
+#endif  // GRID_H
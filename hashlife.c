@@ -0,0 +1,503 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 HashLife engine		<hashlife.c>
+///
+
+#include "hashlife.h"
+#include "plane.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define HL_NONE          UINT32_MAX
+#define HL_DEAD          0  // level 0 node of a dead cell.
+#define HL_ALIVE         1  // level 0 node of a live cell.
+#define HL_MIN_CAPACITY  (1 << 16)
+#define HL_MAX_LEVEL     62  // keeps coordinates within int64_t.
+
+// —————————————————————————————————————————————————————————————————————————————
+// NODE STORE.
+
+static uint64_t hl_hash(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se) {
+    uint64_t h = ((uint64_t)nw << 32 | ne) * 0x9E3779B97F4A7C15ULL;
+    h ^= ((uint64_t)sw << 32 | se) * 0xC2B2AE3D27D4EB4FULL;
+    return h ^ (h >> 29);
+}
+
+static void hl_table_insert(struct Hashlife *hl, uint32_t n) {
+    const struct Hl_Node *node = &hl->nodes[n];
+    size_t slot = hl_hash(node->nw, node->ne, node->sw, node->se) &
+                  hl->table_mask;
+
+    while (hl->table[slot] != HL_NONE) slot = (slot + 1) & hl->table_mask;
+    hl->table[slot] = n;
+}
+
+// Size the table for the current capacity and rehash every live node.
+static int hl_table_rebuild(struct Hashlife *hl) {
+    size_t size = 1;
+
+    while (size < 2 * hl->capacity) size <<= 1;
+    if (size - 1 != hl->table_mask) {
+        uint32_t *table = realloc(hl->table, size * sizeof(*table));
+        if (table == NULL) return -1;
+        hl->table      = table;
+        hl->table_mask = size - 1;
+    }
+    memset(hl->table, 0xFF, size * sizeof(*hl->table));
+    for (size_t n = 2; n < hl->nnode; n += 1) {
+        if (hl->nodes[n].level != HL_NONE) hl_table_insert(hl, (uint32_t)n);
+    }
+    return 0;
+}
+
+static int hl_grow(struct Hashlife *hl) {
+    size_t          capacity = hl->capacity * 2;
+    struct Hl_Node *nodes;
+
+    if (capacity > hl->max_nodes) capacity = hl->max_nodes;
+    if (capacity <= hl->capacity) return -1;
+    nodes = realloc(hl->nodes, capacity * sizeof(*nodes));
+    if (nodes == NULL) return -1;
+    hl->nodes    = nodes;
+    hl->capacity = capacity;
+    return hl_table_rebuild(hl);
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// GARBAGE COLLECTION.
+//
+// Mark everything reachable from the root, the canonical empty nodes and
+// the nodes pinned on `stack` by steps in flight, then put the rest on the
+// free list. Nodes never move, so indices held by callers stay valid.
+// Cached results are not followed; those pointing at a freed node are
+// dropped instead, which is what keeps the cache bounded.
+
+static void hl_pin(struct Hashlife *hl, uint32_t n) {
+    if (hl->nstack == hl->stack_cap) {
+        size_t    cap   = hl->stack_cap ? 2 * hl->stack_cap : 256;
+        uint32_t *stack = realloc(hl->stack, cap * sizeof(*stack));
+
+        if (stack == NULL) {  // Unpinned nodes might be collected.
+            hl->failed = 1;
+            return;
+        }
+        hl->stack     = stack;
+        hl->stack_cap = cap;
+    }
+    hl->stack[hl->nstack++] = n;
+}
+
+static void hl_mark(struct Hashlife *hl, uint8_t *mark, uint32_t n) {
+    while (n > HL_ALIVE && !mark[n]) {
+        const struct Hl_Node *node = &hl->nodes[n];
+
+        mark[n] = 1;
+        hl_mark(hl, mark, node->nw);
+        hl_mark(hl, mark, node->ne);
+        hl_mark(hl, mark, node->sw);
+        n = node->se;
+    }
+}
+
+static int hl_collect(struct Hashlife *hl) {
+    uint8_t *mark = calloc(hl->nnode, 1);
+    size_t   nfreed = 0;
+
+    if (mark == NULL) return -1;
+    hl_mark(hl, mark, hl->root);
+    for (int level = 0; level <= HL_MAX_LEVEL; level += 1) {
+        if (hl->empty[level] != HL_NONE) hl_mark(hl, mark, hl->empty[level]);
+    }
+    for (size_t i = 0; i < hl->nstack; i += 1) hl_mark(hl, mark, hl->stack[i]);
+    hl->free_head = HL_NONE;
+    for (size_t n = 2; n < hl->nnode; n += 1) {
+        struct Hl_Node *node = &hl->nodes[n];
+
+        if (!mark[n]) {
+            node->level   = HL_NONE;
+            node->nw      = hl->free_head;
+            hl->free_head = (uint32_t)n;
+            nfreed += 1;
+        } else if (node->result != HL_NONE && !mark[node->result]) {
+            node->result = HL_NONE;
+        }
+    }
+    free(mark);
+    if (hl_table_rebuild(hl) != 0) return -1;
+    return nfreed >= hl->capacity / 16 ? 0 : -1;  // Or it would thrash.
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// HASH-CONSING.
+
+// The unique node with the given children, made if it does not exist yet.
+static uint32_t hl_node(struct Hashlife *hl, uint32_t nw, uint32_t ne,
+                        uint32_t sw, uint32_t se) {
+    size_t   slot = hl_hash(nw, ne, sw, se) & hl->table_mask;
+    uint32_t n;
+
+    for (; (n = hl->table[slot]) != HL_NONE;
+         slot = (slot + 1) & hl->table_mask) {
+        const struct Hl_Node *node = &hl->nodes[n];
+
+        if (node->nw == nw && node->ne == ne && node->sw == sw && node->se == se)
+            return n;
+    }
+    if (hl->free_head == HL_NONE && hl->nnode == hl->capacity) {
+        size_t base = hl->nstack;
+
+        hl_pin(hl, nw);  // Keep the children alive while making room.
+        hl_pin(hl, ne);
+        hl_pin(hl, sw);
+        hl_pin(hl, se);
+        int made_room = hl_grow(hl) == 0 || hl_collect(hl) == 0;
+        hl->nstack    = base;
+        if (!made_room || hl->failed) {
+            hl->failed = 1;
+            return HL_DEAD;  // Garbage; `failed` tells the caller.
+        }
+        return hl_node(hl, nw, ne, sw, se);  // The table was rebuilt.
+    }
+    if (hl->free_head != HL_NONE) {
+        n             = hl->free_head;
+        hl->free_head = hl->nodes[n].nw;
+    } else {
+        n = (uint32_t)hl->nnode++;
+    }
+    struct Hl_Node *node = &hl->nodes[n];
+    node->nw     = nw;
+    node->ne     = ne;
+    node->sw     = sw;
+    node->se     = se;
+    node->result = HL_NONE;
+    node->level  = hl->nodes[nw].level + 1;
+    node->pop    = hl->nodes[nw].pop + hl->nodes[ne].pop + hl->nodes[sw].pop +
+                hl->nodes[se].pop;
+    hl->table[slot] = n;
+    return n;
+}
+
+static uint32_t hl_empty(struct Hashlife *hl, int level) {
+    if (hl->empty[level] == HL_NONE) {
+        uint32_t child = level == 0 ? HL_DEAD : hl_empty(hl, level - 1);
+        hl->empty[level] = level == 0 ? HL_DEAD
+                                      : hl_node(hl, child, child, child, child);
+    }
+    return hl->empty[level];
+}
+
+// The centre half of node `n`, one level down.
+static uint32_t hl_centre(struct Hashlife *hl, uint32_t n) {
+    const struct Hl_Node node = hl->nodes[n];
+
+    return hl_node(hl, hl->nodes[node.nw].se, hl->nodes[node.ne].sw,
+                   hl->nodes[node.sw].ne, hl->nodes[node.se].nw);
+}
+
+// Node `n` in the middle of an empty node one level up.
+static uint32_t hl_expand(struct Hashlife *hl, uint32_t n) {
+    const struct Hl_Node node = hl->nodes[n];
+    size_t               base = hl->nstack;
+    uint32_t             e, quad[4];
+
+    hl_pin(hl, n);
+    e       = hl_empty(hl, node.level - 1);
+    quad[0] = hl_node(hl, e, e, e, node.nw);
+    hl_pin(hl, quad[0]);
+    quad[1] = hl_node(hl, e, e, node.ne, e);
+    hl_pin(hl, quad[1]);
+    quad[2] = hl_node(hl, e, node.sw, e, e);
+    hl_pin(hl, quad[2]);
+    quad[3]    = hl_node(hl, node.se, e, e, e);
+    hl->nstack = base;
+    return hl_node(hl, quad[0], quad[1], quad[2], quad[3]);
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// STEPPING.
+
+// One generation of the centre 2x2 of a 4x4 node.
+static uint32_t hl_result_leaf(struct Hashlife *hl, uint32_t n) {
+    const struct Hl_Node node      = hl->nodes[n];
+    const uint32_t       quad[4]   = {node.nw, node.ne, node.sw, node.se};
+    uint16_t             bits      = 0;  // bit (4 * row + col).
+    uint32_t             cells[4];
+
+    for (int q = 0; q < 4; q += 1) {
+        const struct Hl_Node *c  = &hl->nodes[quad[q]];
+        int                   r0 = (q >> 1) * 2, c0 = (q & 1) * 2;
+
+        bits |= (uint16_t)(c->nw << (4 * r0 + c0));
+        bits |= (uint16_t)(c->ne << (4 * r0 + c0 + 1));
+        bits |= (uint16_t)(c->sw << (4 * (r0 + 1) + c0));
+        bits |= (uint16_t)(c->se << (4 * (r0 + 1) + c0 + 1));
+    }
+    for (int k = 0; k < 4; k += 1) {
+        int      row = 1 + (k >> 1), col = 1 + (k & 1);
+        unsigned nbhd = 0;  // The 3x3 around (row, col), as `rule` indexes it.
+
+        for (int r = 0; r < 3; r += 1) {
+            nbhd |= ((bits >> (4 * (row - 1 + r) + col - 1)) & 7) << (3 * r);
+        }
+        cells[k] = hl->rule[nbhd] ? HL_ALIVE : HL_DEAD;
+    }
+    return hl_node(hl, cells[0], cells[1], cells[2], cells[3]);
+}
+
+// The centre of level-k node `n` advanced min(2^step_log, 2^(k-2))
+// generations. At full speed (k - 2 <= step_log) both halves of the step
+// recurse; above that the first half just re-centres.
+static uint32_t hl_result(struct Hashlife *hl, uint32_t n) {
+    if (hl->failed) return HL_DEAD;
+    if (hl->nodes[n].result != HL_NONE) return hl->nodes[n].result;
+
+    const struct Hl_Node node = hl->nodes[n];
+    uint32_t             r;
+
+    if (node.pop == 0) {
+        r = hl_empty(hl, node.level - 1);
+    } else if (node.level == 2) {
+        r = hl_result_leaf(hl, n);
+    } else {
+        const int full = (int)node.level - 2 <= hl->step_log;
+        const struct Hl_Node nw = hl->nodes[node.nw], ne = hl->nodes[node.ne];
+        const struct Hl_Node sw = hl->nodes[node.sw], se = hl->nodes[node.se];
+        size_t               base = hl->nstack;
+        uint32_t             sub[9], part[4];
+
+        // The nine overlapping half-size squares, pinned as they are made.
+        hl_pin(hl, n);
+        sub[0] = node.nw;
+        sub[1] = hl_node(hl, nw.ne, ne.nw, nw.se, ne.sw);
+        hl_pin(hl, sub[1]);
+        sub[2] = node.ne;
+        sub[3] = hl_node(hl, nw.sw, nw.se, sw.nw, sw.ne);
+        hl_pin(hl, sub[3]);
+        sub[4] = hl_node(hl, nw.se, ne.sw, sw.ne, se.nw);
+        hl_pin(hl, sub[4]);
+        sub[5] = hl_node(hl, ne.sw, ne.se, se.nw, se.ne);
+        hl_pin(hl, sub[5]);
+        sub[6] = node.sw;
+        sub[7] = hl_node(hl, sw.ne, se.nw, sw.se, se.sw);
+        hl_pin(hl, sub[7]);
+        sub[8] = node.se;
+        for (int i = 0; i < 9; i += 1) {
+            sub[i] = full ? hl_result(hl, sub[i]) : hl_centre(hl, sub[i]);
+            hl_pin(hl, sub[i]);
+        }
+        for (int q = 0; q < 4; q += 1) {
+            int i = (q >> 1) * 3 + (q & 1);
+
+            part[q] = hl_node(hl, sub[i], sub[i + 1], sub[i + 3], sub[i + 4]);
+            hl_pin(hl, part[q]);
+            part[q] = hl_result(hl, part[q]);
+            hl_pin(hl, part[q]);
+        }
+        r          = hl_node(hl, part[0], part[1], part[2], part[3]);
+        hl->nstack = base;
+    }
+    if (!hl->failed) hl->nodes[n].result = r;
+    return r;
+}
+
+// Drop every cached result when the step size changes.
+static void hl_set_step_log(struct Hashlife *hl, int step_log) {
+    if (hl->step_log == step_log) return;
+    for (size_t n = 2; n < hl->nnode; n += 1) hl->nodes[n].result = HL_NONE;
+    hl->step_log = step_log;
+}
+
+// True when every live cell of `n` is in its centre half.
+static int hl_is_centred(const struct Hashlife *hl, uint32_t n) {
+    const struct Hl_Node *node = &hl->nodes[n];
+
+    return hl->nodes[hl->nodes[node->nw].se].pop +
+               hl->nodes[hl->nodes[node->ne].sw].pop +
+               hl->nodes[hl->nodes[node->sw].ne].pop +
+               hl->nodes[hl->nodes[node->se].nw].pop ==
+           node->pop;
+}
+
+int hashlife_advance(struct Hashlife *hl, uint64_t ngen) {
+    for (int j = 63; j >= 0; j -= 1) {
+        if (!(ngen >> j & 1)) continue;
+        hl_set_step_log(hl, j);
+        // Pad the root until the pattern cannot outrun the result square.
+        while ((int)hl->nodes[hl->root].level < j + 2 ||
+               !hl_is_centred(hl, hl->root)) {
+            if ((int)hl->nodes[hl->root].level >= HL_MAX_LEVEL) return -1;
+            hl->root = hl_expand(hl, hl->root);
+        }
+        hl->root = hl_expand(hl, hl->root);
+        hl->root = hl_result(hl, hl->root);
+        if (hl->failed) return -1;
+        hl->generation += (uint64_t)1 << j;
+    }
+    return 0;
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// UNIVERSE LIFETIME.
+
+int hashlife_init(struct Hashlife *hl, size_t max_bytes, struct Rule rule) {
+    memset(hl, 0, sizeof(*hl));
+    if (rule.birth & 1) return -1;
+    rule_table(rule, hl->rule);
+    hl->max_nodes = max_bytes / sizeof(struct Hl_Node);
+    if (hl->max_nodes > HL_NONE) hl->max_nodes = HL_NONE;
+    if (hl->max_nodes < HL_MIN_CAPACITY) hl->max_nodes = HL_MIN_CAPACITY;
+    hl->capacity  = HL_MIN_CAPACITY;
+    hl->nodes     = malloc(hl->capacity * sizeof(*hl->nodes));
+    hl->free_head = HL_NONE;
+    hl->step_log  = -1;
+    if (hl->nodes == NULL || hl_table_rebuild(hl) != 0) {
+        hashlife_free(hl);
+        return -1;
+    }
+    for (int level = 0; level <= HL_MAX_LEVEL; level += 1) {
+        hl->empty[level] = HL_NONE;
+    }
+    hl->nodes[HL_DEAD]  = (struct Hl_Node){0, 0, 0, 0, HL_NONE, 0, 0};
+    hl->nodes[HL_ALIVE] = (struct Hl_Node){0, 0, 0, 0, HL_NONE, 0, 1};
+    hl->nnode           = 2;
+    hl->root            = hl_empty(hl, 3);
+    return 0;
+}
+
+void hashlife_free(struct Hashlife *hl) {
+    free(hl->nodes);
+    free(hl->table);
+    free(hl->stack);
+    memset(hl, 0, sizeof(*hl));
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// GRID IMPORT AND EXPORT.
+
+// The level-`level` square with top left (r0, c0), read from `grid`.
+static uint32_t hl_build(struct Hashlife *hl, const struct Grid *grid,
+                         int level, int64_t r0, int64_t c0) {
+    int64_t size = (int64_t)1 << level;
+
+    if (r0 >= grid->nrow || c0 >= grid->ncol || r0 + size <= 0 ||
+        c0 + size <= 0)
+        return hl_empty(hl, level);
+    if (level == 0) return grid_get(grid, (int)r0, (int)c0);
+    if (level == 6 && r0 >= 0 && c0 >= 0) {  // Skip empty 64x64 blocks fast.
+        uint64_t any = 0;
+
+        for (int64_t i = r0; i < r0 + size && i < grid->nrow; i += 1) {
+            any |= grid_row(grid, (int)i)[c0 >> 6];
+        }
+        if (any == 0) return hl_empty(hl, level);
+    }
+    int64_t  half = size / 2;
+    uint32_t nw   = hl_build(hl, grid, level - 1, r0, c0);
+    hl_pin(hl, nw);
+    uint32_t ne = hl_build(hl, grid, level - 1, r0, c0 + half);
+    hl_pin(hl, ne);
+    uint32_t sw = hl_build(hl, grid, level - 1, r0 + half, c0);
+    hl_pin(hl, sw);
+    uint32_t se = hl_build(hl, grid, level - 1, r0 + half, c0 + half);
+    hl->nstack -= 3;
+    return hl_node(hl, nw, ne, sw, se);
+}
+
+int hashlife_from_grid(struct Hashlife *hl, const struct Grid *grid) {
+    int     level = 1;
+    int64_t half;
+
+    while (((int64_t)1 << (level - 1)) < grid->nrow ||
+           ((int64_t)1 << (level - 1)) < grid->ncol)
+        level += 1;
+    half     = (int64_t)1 << (level - 1);
+    hl->root = hl_empty(hl, 1);  // Let go of the old universe.
+    hl->root = hl_build(hl, grid, level, -half, -half);
+    hl->generation = 0;
+    return hl->failed ? -1 : 0;
+}
+
+static void hl_export(const struct Hashlife *hl, struct Grid *grid,
+                      uint32_t n, int64_t r0, int64_t c0) {
+    const struct Hl_Node *node = &hl->nodes[n];
+    int64_t               size = (int64_t)1 << node->level;
+
+    if (node->pop == 0 || r0 >= grid->nrow || c0 >= grid->ncol ||
+        r0 + size <= 0 || c0 + size <= 0)
+        return;
+    if (node->level == 0) {
+        grid_set(grid, (int)r0, (int)c0, 1);
+        return;
+    }
+    int64_t half = size / 2;
+    hl_export(hl, grid, node->nw, r0, c0);
+    hl_export(hl, grid, node->ne, r0, c0 + half);
+    hl_export(hl, grid, node->sw, r0 + half, c0);
+    hl_export(hl, grid, node->se, r0 + half, c0 + half);
+}
+
+void hashlife_to_grid(const struct Hashlife *hl, struct Grid *grid) {
+    int64_t half = (int64_t)1 << (hl->nodes[hl->root].level - 1);
+
+    for (int i = 0; i < grid->nrow; i += 1) {
+        memset(grid_row(grid, i), 0, grid->nword * sizeof(uint64_t));
+    }
+    hl_export(hl, grid, hl->root, -half, -half);
+}
+
+// Gather the live cells of node `n` into `rows`, bit c of rows[r] for the
+// cell at (r0 + r, c0 + c).
+static void hl_bits(const struct Hashlife *hl, uint32_t n, uint64_t *rows,
+                    int r0, int c0) {
+    const struct Hl_Node *node = &hl->nodes[n];
+
+    if (node->pop == 0) return;
+    if (node->level == 0) {
+        rows[r0] |= (uint64_t)1 << c0;
+        return;
+    }
+    int half = 1 << (node->level - 1);
+    hl_bits(hl, node->nw, rows, r0, c0);
+    hl_bits(hl, node->ne, rows, r0, c0 + half);
+    hl_bits(hl, node->sw, rows, r0 + half, c0);
+    hl_bits(hl, node->se, rows, r0 + half, c0 + half);
+}
+
+static int hl_export_plane(const struct Hashlife *hl, struct Plane *plane,
+                           uint32_t n, int64_t r0, int64_t c0) {
+    const struct Hl_Node *node = &hl->nodes[n];
+
+    if (node->pop == 0) return 0;
+    if (node->level > 6) {  // Split until a row of the square fits a word.
+        int64_t half = (int64_t)1 << (node->level - 1);
+
+        if (hl_export_plane(hl, plane, node->nw, r0, c0) != 0 ||
+            hl_export_plane(hl, plane, node->ne, r0, c0 + half) != 0 ||
+            hl_export_plane(hl, plane, node->sw, r0 + half, c0) != 0)
+            return -1;
+        return hl_export_plane(hl, plane, node->se, r0 + half, c0 + half);
+    }
+    uint64_t rows[64] = {0};
+    int      size     = 1 << node->level;
+
+    hl_bits(hl, n, rows, 0, 0);
+    for (int r = 0; r < size; r += 1) {
+        if (plane_or_row(plane, r0 + r, c0, rows[r]) != 0) return -1;
+    }
+    return 0;
+}
+
+int hashlife_to_plane(const struct Hashlife *hl, struct Plane *plane) {
+    int64_t half = (int64_t)1 << (hl->nodes[hl->root].level - 1);
+
+    return hl_export_plane(hl, plane, hl->root, -half, -half);
+}
@@ -0,0 +1,78 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 HashLife engine		<hashlife.h>
+///
+
+#ifndef HASHLIFE_H
+#define HASHLIFE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "grid.h"
+
+struct Plane;
+
+// —————————————————————————————————————————————————————————————————————————————
+// HASHLIFE UNIVERSE.
+//
+// The plane is a quadtree whose nodes are hash-consed: two squares with the
+// same contents are the same node, whatever their position or generation.
+// Every node of level k (a 2^k square) caches its "result", the centre
+// 2^(k-1) square advanced 2^j generations, so repeated structure in space
+// and time is only ever computed once.
+//
+// Unlike `struct Board`, the plane has no edges. Cells that would leave the
+// board keep evolving outside it and are simply not exported.
+struct Hl_Node {
+    uint32_t nw, ne, sw, se;  // children, or 0/1 for a dead/alive cell.
+    uint32_t result;          // HL_NONE until computed for the current j.
+    uint32_t level;           // HL_NONE marks a free slot.
+    uint64_t pop;             // live cells.
+};
+
+struct Hashlife {
+    struct Hl_Node *nodes;
+    size_t          nnode;      // slots in use, free ones included.
+    size_t          capacity;   // slots allocated.
+    size_t          max_nodes;  // never grow past this, collect instead.
+    uint32_t        free_head;  // free slots, chained through `nw`.
+    uint32_t       *table;      // open addressing over node indices.
+    size_t          table_mask;
+    uint32_t       *stack;      // nodes live on the C stack, GC roots.
+    size_t          nstack, stack_cap;
+    uint32_t        empty[64];  // canonical empty node per level.
+    uint32_t        root;       // covers [-2^(L-1), 2^(L-1)) both ways.
+    int             step_log;   // results advance 2^step_log generations.
+    int             failed;     // ran out of nodes mid-step.
+    uint64_t        generation;
+    uint8_t         rule[512];  // `rule_table` of the rule being run.
+};
+
+// Set up an empty universe running `rule`, using at most about `max_bytes`
+// of nodes. Fails for rules with B0, under which the empty plane itself
+// would change.
+int  hashlife_init(struct Hashlife *hl, size_t max_bytes, struct Rule rule);
+void hashlife_free(struct Hashlife *hl);
+
+// Replace the universe with the cells of `grid`, its top left at (0, 0).
+int hashlife_from_grid(struct Hashlife *hl, const struct Grid *grid);
+// Copy the square the grid covers back out; cells outside are dropped.
+void hashlife_to_grid(const struct Hashlife *hl, struct Grid *grid);
+// OR every live cell into `plane`, at the same coordinates. Returns 0, or
+// -1 if the plane ran out of memory.
+int hashlife_to_plane(const struct Hashlife *hl, struct Plane *plane);
+
+// Advance `ngen` generations, a power of two at a time. Returns 0, or -1
+// when the node budget runs out even after collecting garbage.
+int hashlife_advance(struct Hashlife *hl, uint64_t ngen);
+
+#endif  // HASHLIFE_H
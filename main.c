@@ -12,23 +12,55 @@
 ///
 
 #include <argp.h>
+#include <errno.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 
+#include "batch.h"
+#include "checkpoint.h"
+#include "domain.h"
+#include "gif.h"
+#include "grid.h"
+#include "hashlife.h"
+#include "output.h"
+#include "pattern.h"
+#include "plane.h"
+#include "pool.h"
+#include "profile.h"
+#include "term.h"
+
 // —————————————————————————————————————————————————————————————————————————————
 // DEFINE ROW AND COLUMN COUNT OF GRID.
 #define SCALE_X             1
 #define SCALE_Y             1
-#define NROW                24 / SCALE_X  // height visually.
-#define NCOL                24 / SCALE_Y  // width visually.
+#define NROW                24 / SCALE_X  // default height visually.
+#define NCOL                24 / SCALE_Y  // default width visually.
 #define MAX_NEIGHBOUR_COUNT 9
-#define CELL_SIZE           10
+#define TERM_HEADER_LINES   5  // dev information above the grid.
+#define HASHLIFE_MB         1024
+#define JUMP_MIN_LEAP       64  // generations a HashLife leap must cover.
+#define CHECKPOINT_FILE     "gameoflife.ckpt"
+#define BENCH_GENS          200  // generations timed per trial.
+#define RUN_GENERATIONS     1000  // `--mode run` target by default.
+#define GIF_FRAMES          60
+#define GIF_FPS             10
+#define OUTPUT_QUEUE        8  // frames between the simulation and the writer.
+#define CYCLE_MAX_PERIOD    64
+#define BATCH_DENSITY       0.35  // of random batch seeds.
+#define BENCH_TRIALS        5
+#define SDL_GENS_PER_SEC    60
+#define SDL_STEP_BUDGET_S   0.012  // stepping time per frame at most.
+#define SDL_FRAME_S         (1.0 / 60)
+#define SDL_OVERLAY_S       0.25  // overlay refresh period.
+#define COLOR_CELL_ALIVE    0xFFAAAA00  // ARGB.
+#define COLOR_CELL_DEAD     0xFF000000
 #define SCREEN_WIDTH        800
 #define SCREEN_HEIGHT       600
 
@@ -51,18 +83,19 @@
 #define ENUM_CASE_TO_STR(enum_kind) \
     case enum_kind: return (#enum_kind)
 
-// —————————————————————————————————————————————————————————————————————————————
-// TERMINAL GLYPHS.
-const char GLYPH_GRID_BORDER = ' ';  // @Disabled.
-const char GLYPH_CELL_DEAD   = ' ';
-const char GLYPH_CELL_ALIVE  = 'o';
-
 // —————————————————————————————————————————————————————————————————————————————
 // DATA ENUMERATIONS.
 enum Game_Mode {
     GAME_GIF,
     GAME_SDL,
     GAME_TERMINAL,
+    GAME_BENCH,
+    GAME_RUN,
+    GAME_BATCH,
+};
+enum On_Cycle {
+    ON_CYCLE_STOP,  // report the cycle and end the run.
+    ON_CYCLE_SKIP,  // jump whole periods ahead to the target generation.
 };
 enum Cell_Kind {
     CELL_DEAD  = 0,
@@ -81,17 +114,264 @@ struct Arguments {
     char      *mode;
     enum Color text_color;
     int        help;
+    int        rows;
+    int        cols;
+    int        threads;
+    uint64_t   jump;
+    int        hashlife_mb;
+    int        gens;    // per bench trial.
+    int        trials;  // bench trials, after one warm-up.
+    char      *json;    // bench report path.
+    enum Term_Glyphs glyphs;
+    int        speed;  // SDL generations per second.
+    char      *font;   // SDL overlay font path.
+    char      *pattern;  // seed file, instead of the mode's level.
+    int        top, left;  // pattern offset.
+    uint64_t   checkpoint_every;  // generations, 0 for never.
+    char      *checkpoint_file;
+    char      *resume;            // checkpoint to start from.
+    struct Rule rule;
+    char       *rule_text;  // as given, NULL for the default.
+    uint64_t    generations;  // target, 0 for the mode's default.
+    int         max_period;   // longest cycle looked for, 0 for none.
+    enum On_Cycle on_cycle;
+    char         *seeds;    // batch pattern list, one path per line.
+    int           nrandom;  // batch of random boards instead.
+    double        density;
+    enum Topology topology;
+    int           topology_given;
+    char         *profile;        // report path, GOL_PROFILE builds only.
+    uint64_t      profile_every;  // generations between reports.
+    enum Output_Format       format;  // of `--mode gif` frames.
+    char                    *output;  // frames path, "-" for stdout.
+    enum Output_Backpressure backpressure;
+    int                      queue;  // frames the writer may fall behind.
+    int                 procs;  // run mode worker processes, 1 for none.
+    enum Halo_Transport halo;
+    int           plane;            // the board views an unbounded plane.
+    int64_t       view_top, view_left;  // plane cell at the view's corner.
+};
+enum Option_Key {  // Keys for long-only options, past any ASCII short key.
+    OPT_ROWS = 256,
+    OPT_COLS,
+    OPT_THREADS,
+    OPT_JUMP,
+    OPT_HASHLIFE_MB,
+    OPT_GENS,
+    OPT_TRIALS,
+    OPT_JSON,
+    OPT_GLYPHS,
+    OPT_SPEED,
+    OPT_FONT,
+    OPT_PATTERN,
+    OPT_OFFSET,
+    OPT_CHECKPOINT_EVERY,
+    OPT_CHECKPOINT_FILE,
+    OPT_RESUME,
+    OPT_RULE,
+    OPT_GENERATIONS,
+    OPT_MAX_PERIOD,
+    OPT_ON_CYCLE,
+    OPT_SEEDS,
+    OPT_RANDOM,
+    OPT_DENSITY,
+    OPT_TOPOLOGY,
+    OPT_PROFILE,
+    OPT_PROFILE_EVERY,
+    OPT_PLANE,
+    OPT_VIEW,
+    OPT_FORMAT,
+    OPT_OUTPUT,
+    OPT_BACKPRESSURE,
+    OPT_QUEUE,
+    OPT_PROCS,
+    OPT_HALO,
 };
 static struct argp_option options[] = {
     {"mode", 'm', "MODE", 0, "Set the mode (e.g., GAME_GIF, GAME_TERMINAL)"},
     {"color", 'c', "COLOR", 0, "Set text color"},
     {"help", 'h', 0, 0, "Show the hepl message"},
+    {"rows", OPT_ROWS, "N", 0, "Set the board height in cells (default 24)"},
+    {"cols", OPT_COLS, "N", 0, "Set the board width in cells (default 24)"},
+    {"threads", OPT_THREADS, "N", 0, "Step the board on N threads (default 1)"},
+    {"jump", OPT_JUMP, "N", 0, "Skip the seed N generations ahead (HashLife)"},
+    {"hashlife-mb", OPT_HASHLIFE_MB, "MB", 0,
+     "Memory budget of the HashLife nodes (default 1024)"},
+    {"gens", OPT_GENS, "N", 0, "Generations per bench trial (default 200)"},
+    {"trials", OPT_TRIALS, "N", 0, "Timed bench trials per case (default 5)"},
+    {"json", OPT_JSON, "FILE", 0,
+     "Also write the bench or batch results as JSON"},
+    {"glyphs", OPT_GLYPHS, "KIND", 0,
+     "Terminal cells per character: cell, half (1x2) or braille (2x4)"},
+    {"speed", OPT_SPEED, "N", 0, "Target generations per second (default 60)"},
+    {"font", OPT_FONT, "FILE", 0, "TrueType font for the SDL timing overlay"},
+    {"pattern", OPT_PATTERN, "FILE", 0, "Seed from an RLE or .cells file"},
+    {"offset", OPT_OFFSET, "ROW,COL", 0,
+     "Put the pattern's top left cell there (default 0,0)"},
+    {"checkpoint-every", OPT_CHECKPOINT_EVERY, "N", 0,
+     "Save the board every N generations, in the background"},
+    {"checkpoint-file", OPT_CHECKPOINT_FILE, "FILE", 0,
+     "Where to save checkpoints (default " CHECKPOINT_FILE ")"},
+    {"resume", OPT_RESUME, "FILE", 0, "Start from a saved checkpoint"},
+    {"rule", OPT_RULE, "RULE", 0,
+     "Life-like rule such as B36/S23 (default B3/S23, or the one the "
+     "pattern or checkpoint names)"},
+    {"generations", OPT_GENERATIONS, "N", 0,
+     "Generation to run to (run: 1000, gif: 60 frames)"},
+    {"max-period", OPT_MAX_PERIOD, "N", 0,
+     "Longest cycle a run looks for, 0 for none (default 64)"},
+    {"on-cycle", OPT_ON_CYCLE, "ACTION", 0,
+     "When a run cycles: stop, or skip ahead to --generations"},
+    {"seeds", OPT_SEEDS, "FILE", 0,
+     "Batch: run the pattern files listed in FILE, one per line"},
+    {"random", OPT_RANDOM, "K", 0, "Batch: run K random boards instead"},
+    {"density", OPT_DENSITY, "P", 0,
+     "Live fraction of random batch boards (default 0.35)"},
+    {"topology", OPT_TOPOLOGY, "KIND", 0,
+     "What lies past the edges: dead (default), torus or mirror"},
+    {"profile", OPT_PROFILE, "FILE", 0,
+     "Write phase timings as JSON, or per generation if FILE ends in .csv "
+     "(make profile)"},
+    {"profile-every", OPT_PROFILE_EVERY, "N", 0,
+     "Also write the profile every N generations"},
+    {"plane", OPT_PLANE, 0, 0,
+     "Run on an unbounded plane; the board is a window into it"},
+    {"view", OPT_VIEW, "ROW,COL", 0,
+     "Plane cell at the window's top left (default 0,0; arrow keys pan)"},
+    {"format", OPT_FORMAT, "KIND", 0,
+     "Frames of --mode gif: gif (default), or raw pgm or y4m streams"},
+    {"output", OPT_OUTPUT, "FILE", 0,
+     "Where frames go (default output.gif, or - for stdout if raw)"},
+    {"backpressure", OPT_BACKPRESSURE, "ACTION", 0,
+     "When the frame writer falls behind: block (default) or drop"},
+    {"queue", OPT_QUEUE, "N", 0,
+     "Frames the writer may fall behind by (default 8)"},
+    {"procs", OPT_PROCS, "N", 0,
+     "Run: split the board across N worker processes (default 1)"},
+    {"halo", OPT_HALO, "KIND", 0,
+     "How workers trade edge rows: shm (default) or socket"},
+    {0},
 };
+// Parse a strictly positive int option value or fail with a usage error.
+static int parse_positive_int(const char *arg, struct argp_state *state) {
+    char *end;
+    long  value = strtol(arg, &end, 10);
+
+    if (*arg == '\0' || *end != '\0' || value <= 0 || value > INT32_MAX)
+        argp_error(state, "expected a positive integer, got '%s'", arg);
+    return (int)value;
+}
+// Parse a generation count, which may be far past INT_MAX.
+static uint64_t parse_count(const char *arg, struct argp_state *state) {
+    char              *end;
+    unsigned long long value = strtoull(arg, &end, 10);
+
+    if (*arg == '\0' || *arg == '-' || *end != '\0')
+        argp_error(state, "expected a generation count, got '%s'", arg);
+    return (uint64_t)value;
+}
 static error_t parse_opt(int key, char *arg, struct argp_state *state) {
     struct Arguments *args = (struct Arguments *)state->input;
 
     switch (key) {
     case 'm': args->mode = arg; break;
+    case OPT_ROWS: args->rows = parse_positive_int(arg, state); break;
+    case OPT_COLS: args->cols = parse_positive_int(arg, state); break;
+    case OPT_THREADS: args->threads = parse_positive_int(arg, state); break;
+    case OPT_JUMP: args->jump = parse_count(arg, state); break;
+    case OPT_HASHLIFE_MB:
+        args->hashlife_mb = parse_positive_int(arg, state);
+        break;
+    case OPT_GENS: args->gens = parse_positive_int(arg, state); break;
+    case OPT_TRIALS: args->trials = parse_positive_int(arg, state); break;
+    case OPT_JSON: args->json = arg; break;
+    case OPT_SPEED: args->speed = parse_positive_int(arg, state); break;
+    case OPT_FONT: args->font = arg; break;
+    case OPT_PATTERN: args->pattern = arg; break;
+    case OPT_CHECKPOINT_EVERY:
+        args->checkpoint_every = parse_count(arg, state);
+        break;
+    case OPT_CHECKPOINT_FILE: args->checkpoint_file = arg; break;
+    case OPT_RESUME: args->resume = arg; break;
+    case OPT_RULE:
+        if (rule_parse(arg, &args->rule) != 0)
+            argp_error(state, "expected a rule like B3/S23, got '%s'", arg);
+        args->rule_text = arg;
+        break;
+    case OPT_GENERATIONS: args->generations = parse_count(arg, state); break;
+    case OPT_MAX_PERIOD: {
+        uint64_t period = parse_count(arg, state);
+        if (period > INT32_MAX) argp_error(state, "--max-period is too long");
+        args->max_period = (int)period;
+        break;
+    }
+    case OPT_ON_CYCLE:
+        if (strcmp(arg, "stop") == 0) args->on_cycle = ON_CYCLE_STOP;
+        else if (strcmp(arg, "skip") == 0) args->on_cycle = ON_CYCLE_SKIP;
+        else argp_error(state, "expected stop or skip, got '%s'", arg);
+        break;
+    case OPT_TOPOLOGY:
+        if (strcmp(arg, "dead") == 0) args->topology = TOPOLOGY_DEAD;
+        else if (strcmp(arg, "torus") == 0) args->topology = TOPOLOGY_TORUS;
+        else if (strcmp(arg, "mirror") == 0) args->topology = TOPOLOGY_MIRROR;
+        else argp_error(state, "expected dead, torus or mirror, got '%s'", arg);
+        args->topology_given = 1;
+        break;
+    case OPT_PROFILE: args->profile = arg; break;
+    case OPT_PROFILE_EVERY:
+        args->profile_every = parse_count(arg, state);
+        break;
+    case OPT_SEEDS: args->seeds = arg; break;
+    case OPT_RANDOM: args->nrandom = parse_positive_int(arg, state); break;
+    case OPT_DENSITY: {
+        char *end;
+        args->density = strtod(arg, &end);
+        if (*arg == '\0' || *end != '\0' || !(args->density >= 0) ||
+            args->density > 1)
+            argp_error(state, "expected a fraction in [0, 1], got '%s'", arg);
+        break;
+    }
+    case OPT_OFFSET: {
+        char extra;
+        if (sscanf(arg, "%d,%d%c", &args->top, &args->left, &extra) != 2)
+            argp_error(state, "expected ROW,COL, got '%s'", arg);
+        break;
+    }
+    case OPT_PLANE: args->plane = 1; break;
+    case OPT_VIEW: {
+        char      extra;
+        long long top, left;
+        if (sscanf(arg, "%lld,%lld%c", &top, &left, &extra) != 2)
+            argp_error(state, "expected ROW,COL, got '%s'", arg);
+        args->view_top  = top;
+        args->view_left = left;
+        break;
+    }
+    case OPT_FORMAT:
+        if (strcmp(arg, "gif") == 0) args->format = OUTPUT_GIF;
+        else if (strcmp(arg, "pgm") == 0) args->format = OUTPUT_PGM;
+        else if (strcmp(arg, "y4m") == 0) args->format = OUTPUT_Y4M;
+        else argp_error(state, "expected gif, pgm or y4m, got '%s'", arg);
+        break;
+    case OPT_OUTPUT: args->output = arg; break;
+    case OPT_BACKPRESSURE:
+        if (strcmp(arg, "block") == 0) args->backpressure = OUTPUT_BLOCK;
+        else if (strcmp(arg, "drop") == 0) args->backpressure = OUTPUT_DROP;
+        else argp_error(state, "expected block or drop, got '%s'", arg);
+        break;
+    case OPT_QUEUE: args->queue = parse_positive_int(arg, state); break;
+    case OPT_PROCS: args->procs = parse_positive_int(arg, state); break;
+    case OPT_HALO:
+        if (strcmp(arg, "shm") == 0) args->halo = HALO_SHM;
+        else if (strcmp(arg, "socket") == 0) args->halo = HALO_SOCKET;
+        else argp_error(state, "expected shm or socket, got '%s'", arg);
+        break;
+    case OPT_GLYPHS:
+        if (strcmp(arg, "cell") == 0) args->glyphs = TERM_GLYPHS_CELL;
+        else if (strcmp(arg, "half") == 0) args->glyphs = TERM_GLYPHS_HALF;
+        else if (strcmp(arg, "braille") == 0) args->glyphs = TERM_GLYPHS_BRAILLE;
+        else argp_error(state, "expected cell, half or braille, got '%s'", arg);
+        break;
     case 'c':
         if (strcmp(arg, "red") == 0) args->text_color = COLOR_RED;
         else if (strcmp(arg, "green") == 0) args->text_color = COLOR_GREEN;
@@ -144,154 +424,687 @@ int report_error_fatal(const char *format, ...) {
 }
 
 // —————————————————————————————————————————————————————————————————————————————
-// TERMINAL HELPER FUNCTIONS.
+// GAME LOGIC.
 
-void term_clear_screen() { printf("\033[2J"); }
+// Background checkpoint writer, if `--checkpoint-every` asked for one.
+static struct Checkpointer *checkpointer     = NULL;
+static uint64_t             checkpoint_every = 0;
 
-void term_move_cursor(int row, int col) { printf("\033[%d;%dH", row, col); }
+// Unbounded plane under `--plane`, and the cell of it at the top left of the
+// board, which is then only the window the renderers draw.
+static struct Plane *plane     = NULL;
+static int64_t       view_top  = 0;
+static int64_t       view_left = 0;
 
-void print_grid(const int grid[NROW][NCOL]) {
-    for (int i = 0; i < NROW; i++) {
-        for (int j = 0; j < NCOL; j++) {
-            char cell_char;
+// Copy the plane's window into the board, keeping the window before in the
+// back buffer, and mark it all to be drawn again.
+void show_plane(struct Board *board) {
+    board_swap(board);
+    plane_view(plane, &board->front, view_top, view_left);
+    board_touch(board);
+    board->generation = plane->generation;
+}
 
-            switch (grid[i][j]) {
-            case CELL_DEAD: cell_char = GLYPH_CELL_DEAD; break;
-            case CELL_ALIVE: cell_char = GLYPH_CELL_ALIVE; break;
-            default: report_error_fatal("unexpected cell %d", grid[i][j]);
-            }
+// Update game of life state for current frame's buffer and
+// mutate image.
+//
+// The step itself is `update_state` in <grid.c>, a bit-packed engine
+// writing into the board's back buffer before the two are swapped.
+void update_buffer_and_img(void *img, struct Board *board,
+                           const int frame_num) {
+    PROFILE_BEGIN(PROFILE_STEP);
+    if (plane != NULL) {
+        if (plane_step(plane) != 0)
+            report_error_fatal("out of memory for %zu plane tiles\n",
+                               plane->nlive);
+        show_plane(board);
+    } else {
+        board_step(board);
+    }
+    PROFILE_END(PROFILE_STEP);
+    profile_generation(board);
+    if (checkpointer != NULL && board->generation % checkpoint_every == 0) {
+        PROFILE_BEGIN(PROFILE_CHECKPOINT);
+        checkpoint_post(checkpointer, board);
+        PROFILE_END(PROFILE_CHECKPOINT);
+    }
+};
 
-            switch (j) {
-            case 0: printf("%2c ", cell_char); break;
-            case (NCOL - 1): printf("%2c ", cell_char); break;
-            default: printf("%2c ", cell_char); break;
-            }
+// Load the board into `hl` and advance it `n` generations, from generation
+// `done` of a jump of `ngen`.
+static void hashlife_leap(struct Hashlife *hl, const struct Board *board,
+                          uint64_t n, uint64_t done, uint64_t ngen) {
+    if (hashlife_from_grid(hl, &board->front) != 0)
+        report_error_fatal("could not load board into HashLife\n");
+    if (hashlife_advance(hl, n) != 0)
+        report_error_fatal("HashLife ran out of memory after %llu of %llu "
+                           "generations: raise --hashlife-mb\n",
+                           (unsigned long long)(done + hl->generation),
+                           (unsigned long long)ngen);
+}
+
+// Advance the board `ngen` generations at once with HashLife, whose plane
+// has no edges. Under `--plane` every cell goes on the plane, which starts
+// out with the same cells at the same coordinates. A bounded board's dead
+// edges kill whatever crosses them, so there each leap only goes as many
+// generations as the live cells are from the nearest edge, which none can
+// reach any sooner. Closer than JUMP_MIN_LEAP, the board steps as usual.
+void jump_ahead(struct Board *board, uint64_t ngen, size_t max_bytes) {
+    struct Hashlife hl;
+    uint64_t        done = 0;
+
+    if (board->rule.birth & 1)
+        report_error_fatal("--jump cannot run rules with B0\n");
+    if (board->topology != TOPOLOGY_DEAD)
+        report_error_fatal("--jump only runs with --topology dead\n");
+    if (hashlife_init(&hl, max_bytes, board->rule) != 0)
+        report_error_fatal("could not load board into HashLife\n");
+    if (plane != NULL) {
+        struct Pool *pool = plane->pool;
+
+        hashlife_leap(&hl, board, ngen, 0, ngen);
+        plane_free(plane);
+        if (plane_init(plane, board->rule) != 0 ||
+            hashlife_to_plane(&hl, plane) != 0)
+            report_error_fatal("out of memory\n");
+        plane->pool       = pool;
+        plane->generation = board->generation + ngen;
+        done              = ngen;
+    }
+    while (done < ngen) {
+        const int margin = grid_margin(&board->front);
+        uint64_t  n      = ngen - done;
+
+        if (margin < 0) {  // Nothing left alive to change.
+            board->generation += n;
+            break;
+        }
+        if ((uint64_t)margin < JUMP_MIN_LEAP) {
+            if (n > JUMP_MIN_LEAP) n = JUMP_MIN_LEAP;
+            for (uint64_t g = 0; g < n; g += 1) board_step(board);
+        } else {
+            if (n > (uint64_t)margin) n = margin;
+            hashlife_leap(&hl, board, n, done, ngen);
+            hashlife_to_grid(&hl, &board->front);
+            board_touch(board);
+            board->generation += n;
         }
-        printf("\n");
+        done += n;
     }
+    hashlife_free(&hl);
 }
 
 // —————————————————————————————————————————————————————————————————————————————
-// GAME LOGIC.
+// GAME INITIAL MAP LEVELS.
 
-// Update game of life state.
-void update_state(int new_grid[NROW][NCOL], const int grid[NROW][NCOL]) {
-    // —————————————————————————————————————————————————————————————————————————
-    // Copy grid to new_grid.
-    for (int i = 0; i < NROW; i += 1) {
-        for (int j = 0; j < NCOL; j += 1) { new_grid[i][j] = grid[i][j]; }
+void game_level_1(struct Grid *grid, int *choices_arr, int i, int j) {
+    if (i != 0 && i % 17 == 0) grid_set(grid, i, j, choices_arr[i % 2]);
+    else if (j != 0 && j % 23 == 0) grid_set(grid, i, j, choices_arr[j % 2]);
+    else grid_set(grid, i, j, 0);
+}
+
+void game_level_2(struct Grid *grid, int *choices_arr, int i, int j) {
+    if (i != 0 && i % 13 == 0) grid_set(grid, i, j, choices_arr[i % 2]);
+    else if (j != 0 && j % 19 == 0) grid_set(grid, i, j, choices_arr[j % 2]);
+    else grid_set(grid, i, j, 0);
+}
+
+void game_level_3(struct Grid *grid, int *choices_arr, int i, int j) {
+    if (i != 0 && i % 21 == 0) grid_set(grid, i, j, choices_arr[i % 2]);
+    else if (j != 0 && j % 8 == 0) grid_set(grid, i, j, choices_arr[j % 2]);
+    else if (i != 0 && j != 0 && (i == j))
+        grid_set(grid, i, j, choices_arr[j % 2]);
+    else grid_set(grid, i, j, 0);
+}
+
+void game_level_4(struct Grid *grid, int *choices_arr, int i, int j) {
+    if (i % 3 == 0) grid_set(grid, i, j, choices_arr[j % 2]);
+    else if (j % 5 == 0) grid_set(grid, i, j, choices_arr[i % 2]);
+    else grid_set(grid, i, j, 0);
+}
+
+void game_level_glider(struct Grid *grid, int i, int j) {
+    // Create a glider pattern at position (i, j)
+    if (i >= 0 && i + 2 < grid->nrow && j >= 0 && j + 2 < grid->ncol) {
+        grid_set(grid, i, j + 1, 1);
+        grid_set(grid, i + 1, j + 2, 1);
+        grid_set(grid, i + 2, j, 1);
+        grid_set(grid, i + 2, j + 1, 1);
+        grid_set(grid, i + 2, j + 2, 1);
     }
-    // —————————————————————————————————————————————————————————————————————————
-    // Run a single game instant.
-    for (int x = 0; x < NROW; x += 1) {
-        for (int y = 0; y < NCOL; y += 1) {
-            // —————————————————————————————————————————————————————————————————
-            // Calculate count of live offset neighbours.
-            int live_neighbours = 0;
+}
 
-            for (int dx = -1; dx <= 1; dx += 1) {  // Collect 3x3 neighbours.
-                for (int dy = -1; dy <= 1; dy += 1) {
-                    int nx = x + dx, ny = y + dy;
+// Report why `path` failed to load and exit.
+void pattern_error_fatal(const char *path, const struct Pattern_Error *error) {
+    if (error->line > 0)
+        report_error_fatal("%s:%d:%d: %s\n", path, error->line, error->col,
+                           error->message);
+    report_error_fatal("%s: %s\n", path, error->message);
+}
 
-                    if (dx == 0 && dy == 0) continue;  // Skip if it's cur cell.
+// Put the seeded board on the plane with its top left cell at (0, 0). The
+// board keeps the seed until `show_plane` brings in the window at `--view`.
+void start_plane(struct Board *board, const struct Arguments *args) {
+    static struct Plane storage;
 
-                    if ((nx >= 0 && nx < NROW) && (ny >= 0 && ny < NCOL)) {
-                        live_neighbours += new_grid[nx][ny];  // Inside bounds.
-                    }
-                }
-            }
-            // —————————————————————————————————————————————————————————————————
-            // Apply rules of the game.
-            switch (grid[x][y]) {
-            case CELL_ALIVE:
-                if (live_neighbours < 2 || live_neighbours > 3)
-                    new_grid[x][y] = CELL_DEAD;
-                else new_grid[x][y] = CELL_ALIVE;
-                break;
-            case CELL_DEAD:
-                if (live_neighbours == 3) new_grid[x][y] = CELL_ALIVE;
-                else new_grid[x][y] = CELL_DEAD;
-                break;
-            }
+    if (plane_init(&storage, args->rule) != 0 ||
+        plane_from_grid(&storage, &board->front, 0, 0) != 0)
+        report_error_fatal("out of memory\n");
+    storage.pool       = board->pool;
+    storage.generation = board->generation;
+    plane              = &storage;
+    view_top           = args->view_top;
+    view_left          = args->view_left;
+}
+
+// Seed the board from `--resume` or `--pattern` if given, or else from
+// `level`, then put it on the plane under `--plane` and apply any `--jump`.
+void load_game(struct Board *board, const struct Arguments *args,
+               void (*level)(struct Grid *, int *, int, int)) {
+    struct Grid *grid          = &board->front;
+    int          choices_arr[] = {0, 1};  // Fill grid with any of these values.
+
+    PROFILE_BEGIN(PROFILE_LOAD);
+    if (args->resume != NULL) {
+        const char *error;
+
+        if (checkpoint_resume(board, args->resume, &error) != 0)
+            report_error_fatal("%s: %s\n", args->resume, error);
+    } else if (args->pattern != NULL) {
+        struct Pattern_Error error;
+
+        if (pattern_load(grid, args->pattern, args->top, args->left, &error) !=
+            0)
+            pattern_error_fatal(args->pattern, &error);
+    } else {
+        for (int i = 0; i < grid->nrow; i += 1) {
+            for (int j = 0; j < grid->ncol; j += 1)
+                level(grid, choices_arr, i, j);
         }
     }
+    board_touch(board);
+    if (args->plane) start_plane(board, args);
+    if (args->jump > 0)
+        jump_ahead(board, args->jump, (size_t)args->hashlife_mb << 20);
+    if (plane != NULL) show_plane(board);
+    PROFILE_END(PROFILE_LOAD);
 }
 
-// Update game of life state for current frame's buffer and
-// mutate image.
-void update_buffer_and_img(void *img, int new_grid[NROW][NCOL],
-                           int grid[NROW][NCOL], const int frame_num) {
-    update_state(new_grid, grid);
+// —————————————————————————————————————————————————————————————————————————————
+// HEADLESS RUN.
+//
+// Steps the board to the target generation with no rendering. Unless
+// `--max-period` is 0, the board's hash goes into a ring after every step,
+// so a board that died out, settled or started to oscillate is caught
+// within one period of doing so. The first repeat found is the earliest:
+// had the cycle started sooner, it would have repeated sooner. Under
+// `--plane` it is the plane's hash, so a pattern that only moves away never
+// repeats.
+// Under `--procs` the board is handed to worker processes, see <domain.h>,
+// and stepped straight to the target with no cycle detection.
 
-    for (int i = 0; i < NROW; i += 1) {  // Copy updated new_grid into grid.
-        for (int j = 0; j < NCOL; j += 1) { grid[i][j] = new_grid[i][j]; }
+// Hash of the whole state: the plane's, or else the board's.
+static uint64_t state_hash(const struct Board *board) {
+    return plane != NULL ? plane->hash : board->hash;
+}
+
+void run_generations(struct Board *board, const struct Arguments *args) {
+    const uint64_t target =
+        args->generations > 0 ? args->generations : RUN_GENERATIONS;
+    struct Cycle_Finder finder;
+    int                 period = 0;
+
+    if (args->procs > 1) {  // Straight to the target, no cycles looked for.
+        struct Domain_Config config = {args->procs, args->halo};
+
+        if (board->generation < target &&
+            domain_run(board, target - board->generation, &config) != 0)
+            report_error_fatal("worker processes failed: %s\n",
+                               errno != 0 ? strerror(errno)
+                                          : "one exited with an error");
+        printf("generation %llu, population %llu\n",
+               (unsigned long long)board->generation,
+               (unsigned long long)grid_population(&board->front));
+        return;
     }
-};
+    if (args->max_period > 0) {
+        if ((plane == NULL && board_track_hash(board) != 0) ||
+            cycle_init(&finder, args->max_period) != 0)
+            report_error_fatal("out of memory\n");
+        cycle_push(&finder, state_hash(board));
+    }
+    while (board->generation < target && period == 0) {
+        update_buffer_and_img(NULL, board, 0);
+        if (args->max_period > 0)
+            period = cycle_push(&finder, state_hash(board));
+    }
+    if (period > 0) {
+        const uint64_t found = board->generation;
+
+        if (state_hash(board) == 0)
+            printf("died out at generation %llu\n",
+                   (unsigned long long)(found - period));
+        else
+            printf("entered a cycle of period %d at generation %llu\n", period,
+                   (unsigned long long)(found - period));
+        if (args->on_cycle == ON_CYCLE_SKIP) {
+            uint64_t left = target - found;
+
+            // Whole periods change nothing; step only what is left over.
+            board->generation += left - left % period;
+            if (plane != NULL) plane->generation = board->generation;
+            for (uint64_t k = 0; k < left % period; k += 1)
+                update_buffer_and_img(NULL, board, 0);
+            // The skipped generations never came round to a checkpoint.
+            if (checkpointer != NULL) checkpoint_post(checkpointer, board);
+        }
+        cycle_free(&finder);
+    } else if (args->max_period > 0) {
+        cycle_free(&finder);
+    }
+    if (plane != NULL) {
+        printf("generation %llu, population %llu, %zu tiles\n",
+               (unsigned long long)board->generation,
+               (unsigned long long)plane_population(plane), plane->nlive);
+        return;
+    }
+    printf("generation %llu, population %llu\n",
+           (unsigned long long)board->generation,
+           (unsigned long long)grid_population(&board->front));
+}
 
 // —————————————————————————————————————————————————————————————————————————————
-// BUFFER WRITER IMAGE HELPERS.
+// BENCHMARK.
+//
+// Steps every seed below on every board size with no rendering or pacing.
+// Each case runs one untimed warm-up trial, so the caches and the pool are
+// hot, then `--trials` timed ones of `--gens` generations each. Seeds are
+// deterministic, random ones included, so runs are comparable.
 
-// Write bytes to a stream or file.
-void write_bytes(FILE *file, uint8_t *data, int size) {
-    for (int i = 0; i < size; i += 1) fputc(data[i], file);
+static const int bench_sizes[] = {64, 256, 1024, 4096};
+
+enum Bench_Seed {
+    BENCH_LEVEL_1,
+    BENCH_LEVEL_2,
+    BENCH_LEVEL_3,
+    BENCH_LEVEL_4,
+    BENCH_GLIDERS,
+    BENCH_RANDOM_10,
+    BENCH_RANDOM_35,
+    BENCH_RANDOM_50,
+    BENCH_SEED_COUNT,
+};
+static const char *bench_seed_names[BENCH_SEED_COUNT] = {
+    "level_1", "level_2", "level_3",   "level_4",
+    "gliders", "random_10", "random_35", "random_50",
+};
+
+struct Bench_Result {
+    const char *seed;
+    int         nrow, ncol;
+    double      gens_per_sec;
+    double      cells_per_sec;
+    double      p50_us, p99_us;  // per-step latency.
+};
+
+static double now_seconds(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
 }
 
-void convert_grid_to_image(int            new_grid[NROW][NCOL],
-                           uint8_t *const image_data) {
-    uint8_t background_color = 0x00;
+static void bench_seed(struct Grid *grid, enum Bench_Seed seed) {
+    int      choices_arr[] = {0, 1};
+    uint64_t state         = 0x9E3779B97F4A7C15ull;  // Fixed, reproducible.
+    int      percent;
 
-    for (int i = 0; i < NROW; i += 1) {  // Init image with the background.
-        for (int j = 0; j < NCOL; j += 1) {
-            image_data[((i * NROW) + j)] = background_color;
+    switch (seed) {
+    case BENCH_LEVEL_1:
+    case BENCH_LEVEL_2:
+    case BENCH_LEVEL_3:
+    case BENCH_LEVEL_4:
+        for (int i = 0; i < grid->nrow; i += 1) {
+            for (int j = 0; j < grid->ncol; j += 1) {
+                if (seed == BENCH_LEVEL_1) game_level_1(grid, choices_arr, i, j);
+                if (seed == BENCH_LEVEL_2) game_level_2(grid, choices_arr, i, j);
+                if (seed == BENCH_LEVEL_3) game_level_3(grid, choices_arr, i, j);
+                if (seed == BENCH_LEVEL_4) game_level_4(grid, choices_arr, i, j);
+            }
         }
+        return;
+    case BENCH_GLIDERS:  // One glider every 16 cells both ways.
+        for (int i = 0; i < grid->nrow; i += 16) {
+            for (int j = 0; j < grid->ncol; j += 16) game_level_glider(grid, i, j);
+        }
+        return;
+    case BENCH_RANDOM_10: percent = 10; break;
+    case BENCH_RANDOM_35: percent = 35; break;
+    case BENCH_RANDOM_50: percent = 50; break;
+    default: report_error_fatal("unexpected bench seed %d", seed); return;
     }
-    // Map `CELL_DEAD` and `CELL_ALIVE` to appropriate pixel values.
-    for (int i = 0; i < NROW; i += 1) {
-        for (int j = 0; j < NCOL; j += 1) {
-            int     px                   = new_grid[i][j];
-            uint8_t pixel_val            = (px == CELL_ALIVE) ? 0xFF : 0x00;
-            image_data[((i * NROW) + j)] = pixel_val;
+    for (int i = 0; i < grid->nrow; i += 1) {
+        for (int j = 0; j < grid->ncol; j += 1) {
+            state ^= state << 13, state ^= state >> 7, state ^= state << 17;
+            grid_set(grid, i, j, (int)(state % 100) < percent);
         }
     }
 }
 
-// —————————————————————————————————————————————————————————————————————————————
-// GAME INITIAL MAP LEVELS.
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static struct Bench_Result bench_case(int nrow, int ncol, enum Bench_Seed seed,
+                                      struct Rule rule, int gens, int trials,
+                                      struct Pool *pool, double *step_secs) {
+    struct Board        board;
+    struct Bench_Result result = {bench_seed_names[seed], nrow, ncol};
+    double              total  = 0;
+
+    if (board_init(&board, nrow, ncol) != 0)
+        report_error_fatal("could not allocate %dx%d board\n", nrow, ncol);
+    board.pool = pool;
+    board_set_rule(&board, rule);
+    for (int trial = -1; trial < trials; trial += 1) {  // -1 is the warm-up.
+        bench_seed(&board.front, seed);
+        board_touch(&board);
+        for (int gen = 0; gen < gens; gen += 1) {
+            double start = now_seconds();
+            board_step(&board);
+            double secs = now_seconds() - start;
 
-void game_level_1(int grid[NROW][NCOL], int *choices_arr, int i, int j) {
-    if (i != 0 && i % 17 == 0) grid[i][j] = choices_arr[i % 2];
-    else if (j != 0 && j % 23 == 0) grid[i][j] = choices_arr[j % 2];
-    else grid[i][j] = 0;
+            if (trial < 0) continue;
+            step_secs[trial * gens + gen] = secs;
+            total += secs;
+        }
+    }
+    board_free(&board);
+
+    int nstep = gens * trials;
+    qsort(step_secs, nstep, sizeof(*step_secs), compare_doubles);
+    result.gens_per_sec  = nstep / total;
+    result.cells_per_sec = result.gens_per_sec * nrow * ncol;
+    result.p50_us        = step_secs[nstep / 2] * 1e6;
+    result.p99_us        = step_secs[(int)(nstep * 0.99)] * 1e6;
+
+    return result;
 }
 
-void game_level_2(int grid[NROW][NCOL], int *choices_arr, int i, int j) {
-    if (i != 0 && i % 13 == 0) grid[i][j] = choices_arr[i % 2];
-    else if (j != 0 && j % 19 == 0) grid[i][j] = choices_arr[j % 2];
-    else grid[i][j] = 0;
+void run_bench(const struct Arguments *args, struct Pool *pool) {
+    const int nsize    = sizeof(bench_sizes) / sizeof(*bench_sizes);
+    const int nresult  = nsize * BENCH_SEED_COUNT;
+    int       nthread  = pool == NULL ? 1 : pool_size(pool);
+    double   *step_secs = malloc(sizeof(double) * args->gens * args->trials);
+    struct Bench_Result *results = malloc(sizeof(*results) * nresult);
+    FILE                *json    = NULL;
+    const char *rule = args->rule_text != NULL ? args->rule_text : "B3/S23";
+
+    if (step_secs == NULL || results == NULL)
+        report_error_fatal("out of memory\n");
+    if (args->json != NULL && (json = fopen(args->json, "w")) == NULL)
+        report_error_fatal("could not open '%s': %s\n", args->json,
+                           strerror(errno));
+    printf("kernel %s, rule %s, %d thread(s), %d trial(s) of %d generations\n",
+           grid_kernel_name(), rule, nthread, args->trials, args->gens);
+    printf("%-10s %11s %12s %14s %10s %10s\n", "seed", "size", "gens/s",
+           "cells/s", "p50(us)", "p99(us)");
+    for (int s = 0; s < nsize; s += 1) {
+        for (int seed = 0; seed < BENCH_SEED_COUNT; seed += 1) {
+            struct Bench_Result *r = &results[s * BENCH_SEED_COUNT + seed];
+
+            *r = bench_case(bench_sizes[s], bench_sizes[s], seed, args->rule,
+                            args->gens, args->trials, pool, step_secs);
+            printf("%-10s %5dx%-5d %12.1f %14.4g %10.2f %10.2f\n", r->seed,
+                   r->nrow, r->ncol, r->gens_per_sec, r->cells_per_sec,
+                   r->p50_us, r->p99_us);
+            fflush(stdout);
+        }
+    }
+    if (json != NULL) {
+        fprintf(json,
+                "{\"kernel\": \"%s\", \"rule\": \"%s\", \"threads\": %d, "
+                "\"trials\": %d, \"gens\": %d, \"results\": [\n",
+                grid_kernel_name(), rule, nthread, args->trials, args->gens);
+        for (int k = 0; k < nresult; k += 1) {
+            const struct Bench_Result *r = &results[k];
+
+            fprintf(json,
+                    "  {\"seed\": \"%s\", \"rows\": %d, \"cols\": %d, "
+                    "\"gens_per_sec\": %.3f, \"cells_per_sec\": %.6g, "
+                    "\"p50_us\": %.3f, \"p99_us\": %.3f}%s\n",
+                    r->seed, r->nrow, r->ncol, r->gens_per_sec,
+                    r->cells_per_sec, r->p50_us, r->p99_us,
+                    k + 1 < nresult ? "," : "");
+        }
+        fprintf(json, "]}\n");
+        if (fclose(json) != 0)
+            report_error_fatal("could not write '%s': %s\n", args->json,
+                               strerror(errno));
+    }
+    free(results);
+    free(step_secs);
 }
 
-void game_level_3(int grid[NROW][NCOL], int *choices_arr, int i, int j) {
-    if (i != 0 && i % 21 == 0) grid[i][j] = choices_arr[i % 2];
-    else if (j != 0 && j % 8 == 0) grid[i][j] = choices_arr[j % 2];
-    else if (i != 0 && j != 0 && (i == j)) grid[i][j] = choices_arr[j % 2];
-    else grid[i][j] = 0;
+// —————————————————————————————————————————————————————————————————————————————
+// BATCH.
+//
+// Runs every seed on its own board of --rows x --cols to --generations,
+// and prints one summary per seed followed by the overall throughput.
+
+static const char *batch_status_names[] = {"alive", "died", "cycled",
+                                           "failed"};
+
+// Read the non-empty lines of `path` that are not `#` comments.
+static char **read_seed_list(const char *path, int *count) {
+    FILE   *file  = fopen(path, "r");
+    char  **paths = NULL, *line = NULL;
+    size_t  cap   = 0;
+    ssize_t len;
+    int     n = 0, room = 0;
+
+    if (file == NULL)
+        report_error_fatal("could not open '%s': %s\n", path, strerror(errno));
+    while ((len = getline(&line, &cap, file)) >= 0) {
+        while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r'))
+            line[--len] = '\0';
+        if (len == 0 || line[0] == '#') continue;
+        if (n == room) {
+            room  = room > 0 ? 2 * room : 64;
+            paths = realloc(paths, sizeof(*paths) * room);
+            if (paths == NULL) report_error_fatal("out of memory\n");
+        }
+        if ((paths[n++] = strdup(line)) == NULL)
+            report_error_fatal("out of memory\n");
+    }
+    free(line);
+    fclose(file);
+    *count = n;
+    return paths;
 }
 
-void game_level_4(int grid[NROW][NCOL], int *choices_arr, int i, int j) {
-    if (i % 3 == 0) grid[i][j] = choices_arr[j % 2];
-    else if (j % 5 == 0) grid[i][j] = choices_arr[i % 2];
-    else grid[i][j] = 0;
+// Write `text` as a JSON string.
+static void json_string(FILE *json, const char *text) {
+    fputc('"', json);
+    for (; *text != '\0'; text += 1) {
+        if (*text == '"' || *text == '\\') fputc('\\', json);
+        if ((unsigned char)*text >= 0x20) fputc(*text, json);
+    }
+    fputc('"', json);
 }
 
-void game_level_glider(int grid[NROW][NCOL], int i, int j) {
-    // Create a glider pattern at position (i, j)
-    if (i >= 0 && i + 2 < NROW && j >= 0 && j + 2 < NCOL) {
-        grid[i][j + 1]     = 1;
-        grid[i + 1][j + 2] = 1;
-        grid[i + 2][j]     = 1;
-        grid[i + 2][j + 1] = 1;
-        grid[i + 2][j + 2] = 1;
+void run_batch(const struct Arguments *args, struct Pool *pool) {
+    struct Batch_Config config = {
+        .nrow        = args->rows,
+        .ncol        = args->cols,
+        .rule        = args->rule,
+        .generations = args->generations > 0 ? args->generations
+                                             : RUN_GENERATIONS,
+        .max_period  = args->max_period,
+        .nrandom     = args->nrandom,
+        .density     = args->density,
+        .top         = args->top,
+        .left        = args->left,
+    };
+    int  nthread = pool == NULL ? 1 : pool_size(pool);
+    char seed[32];
+    FILE *json = NULL;
+
+    if (args->topology != TOPOLOGY_DEAD)
+        report_error_fatal("batch boards are packed with dead edges: "
+                           "--topology is not supported\n");
+    if (args->seeds != NULL)
+        config.paths = read_seed_list(args->seeds, &config.npath);
+    else if (args->nrandom == 0)
+        report_error_fatal("batch needs --seeds FILE or --random K\n");
+    if (batch_count(&config) == 0)
+        report_error_fatal("%s lists no seeds\n", args->seeds);
+    // Without --rule, run the boards under the rule their patterns name,
+    // which must then be the same for all. Unreadable ones fail to load.
+    for (int k = 0, named = -1; args->rule_text == NULL && k < config.npath;
+         k += 1) {
+        struct Rule          rule = config.rule;
+        struct Pattern_Error error;
+
+        if (pattern_rule(config.paths[k], &rule, &error) != 1) continue;
+        if (named < 0) {
+            config.rule = rule;
+            named       = k;
+        } else if (rule.birth != config.rule.birth ||
+                   rule.survive != config.rule.survive) {
+            report_error_fatal("%s and %s name different rules: pass "
+                               "--rule\n",
+                               config.paths[named], config.paths[k]);
+        }
+    }
+    if (args->json != NULL && (json = fopen(args->json, "w")) == NULL)
+        report_error_fatal("could not open '%s': %s\n", args->json,
+                           strerror(errno));
+
+    int                  nboard  = batch_count(&config);
+    struct Batch_Result *results = malloc(sizeof(*results) * nboard);
+    if (results == NULL) report_error_fatal("out of memory\n");
+
+    double start = now_seconds();
+    if (batch_run(&config, pool, results) != 0)
+        report_error_fatal("out of memory\n");
+    double secs = now_seconds() - start;
+
+    int count[BATCH_FAILED + 1] = {0};
+    printf("%-24s %-7s %12s %7s %11s %s\n", "seed", "status", "generation",
+           "period", "population", "bbox(top,left,bottom,right)");
+    for (int k = 0; k < nboard; k += 1) {
+        const struct Batch_Result *r = &results[k];
+        const char *name = config.npath > 0 ? config.paths[k] : seed;
+
+        if (config.npath == 0) snprintf(seed, sizeof(seed), "random:%d", k);
+        count[r->status] += 1;
+        if (r->status == BATCH_FAILED) {
+            if (r->error.line > 0)
+                report_error("%s:%d:%d: %s\n", name, r->error.line,
+                             r->error.col, r->error.message);
+            else
+                report_error("%s: %s\n", name, r->error.message);
+            continue;
+        }
+        printf("%-24s %-7s %12llu %7d %11llu %d,%d,%d,%d\n", name,
+               batch_status_names[r->status],
+               (unsigned long long)r->generation, r->period,
+               (unsigned long long)r->population, r->top, r->left, r->bottom,
+               r->right);
+    }
+    printf("%d boards of %dx%d to generation %llu on %d thread(s): "
+           "%d alive, %d died, %d cycled, %d failed\n"
+           "%.3f s, %.1f boards/s\n",
+           nboard, config.nrow, config.ncol,
+           (unsigned long long)config.generations, nthread, count[BATCH_ALIVE],
+           count[BATCH_DIED], count[BATCH_CYCLED], count[BATCH_FAILED], secs,
+           nboard / secs);
+    if (json != NULL) {
+        fprintf(json,
+                "{\"rows\": %d, \"cols\": %d, \"generations\": %llu, "
+                "\"threads\": %d, \"seconds\": %.6f, \"boards_per_sec\": "
+                "%.3f, \"results\": [\n",
+                config.nrow, config.ncol,
+                (unsigned long long)config.generations, nthread, secs,
+                nboard / secs);
+        for (int k = 0; k < nboard; k += 1) {
+            const struct Batch_Result *r = &results[k];
+
+            if (config.npath == 0) snprintf(seed, sizeof(seed), "random:%d", k);
+            fprintf(json, "  {\"seed\": ");
+            json_string(json, config.npath > 0 ? config.paths[k] : seed);
+            fprintf(json,
+                    ", \"status\": \"%s\", \"generation\": %llu, "
+                    "\"period\": %d, \"population\": %llu, "
+                    "\"bbox\": [%d, %d, %d, %d]}%s\n",
+                    batch_status_names[r->status],
+                    (unsigned long long)r->generation, r->period,
+                    (unsigned long long)r->population, r->top, r->left,
+                    r->bottom, r->right, k + 1 < nboard ? "," : "");
+        }
+        fprintf(json, "]}\n");
+        if (fclose(json) != 0)
+            report_error_fatal("could not write '%s': %s\n", args->json,
+                               strerror(errno));
     }
+    for (int k = 0; k < config.npath; k += 1) free(config.paths[k]);
+    free(config.paths);
+    free(results);
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// SDL HELPERS.
+
+// Repaint the `redraw` tiles of `pixels`, one ARGB pixel per cell, and grow
+// `bounds` to cover them. Returns the number of tiles painted.
+static int paint_tiles(const struct Board *board, const uint8_t *redraw,
+                       uint32_t *pixels, SDL_Rect *bounds) {
+    const struct Grid *grid  = &board->front;
+    int                count = 0;
+    int x0 = grid->ncol, y0 = grid->nrow, x1 = 0, y1 = 0;
+
+    for (int trow = 0; trow < board->tile_nrow; trow += 1) {
+        for (int tcol = 0; tcol < board->tile_ncol; tcol += 1) {
+            if (!redraw[trow * board->tile_ncol + tcol]) continue;
+
+            int i_begin = trow * TILE_ROWS, i_end = i_begin + TILE_ROWS;
+            int j_begin = tcol * TILE_COLS, j_end = j_begin + TILE_COLS;
+            if (i_end > grid->nrow) i_end = grid->nrow;
+            if (j_end > grid->ncol) j_end = grid->ncol;
+            for (int i = i_begin; i < i_end; i += 1) {
+                const uint64_t *row = grid_row(grid, i);
+                uint32_t       *out = pixels + (size_t)i * grid->ncol;
+
+                for (int j = j_begin; j < j_end; j += 1) {
+                    out[j] = (row[j >> 6] >> (j & 63)) & 1 ? COLOR_CELL_ALIVE
+                                                           : COLOR_CELL_DEAD;
+                }
+            }
+            if (j_begin < x0) x0 = j_begin;
+            if (i_begin < y0) y0 = i_begin;
+            if (j_end > x1) x1 = j_end;
+            if (i_end > y1) y1 = i_end;
+            count += 1;
+        }
+    }
+    *bounds = (SDL_Rect){x0, y0, x1 - x0, y1 - y0};
+    return count;
+}
+
+// Largest rectangle of the board's aspect ratio centred in the output.
+static SDL_Rect fit_rect(SDL_Renderer *renderer, int w, int h) {
+    int out_w = SCREEN_WIDTH, out_h = SCREEN_HEIGHT;
+
+    SDL_GetRendererOutputSize(renderer, &out_w, &out_h);
+    double scale = (double)out_w / w < (double)out_h / h ? (double)out_w / w
+                                                         : (double)out_h / h;
+    SDL_Rect rect = {0, 0, (int)(w * scale), (int)(h * scale)};
+    rect.x        = (out_w - rect.w) / 2;
+    rect.y        = (out_h - rect.h) / 2;
+
+    return rect;
 }
 
 // —————————————————————————————————————————————————————————————————————————————
@@ -301,7 +1114,18 @@ int main(int argc, char **argv) {
 
     // —————————————————————————————————————————————————————————————————————————
     // PARSE COMMAND LINE ARGS.
-    struct Arguments args = {0};
+    struct Arguments args = {.rows        = NROW,
+                             .cols        = NCOL,
+                             .threads     = 1,
+                             .hashlife_mb = HASHLIFE_MB,
+                             .gens        = BENCH_GENS,
+                             .trials      = BENCH_TRIALS,
+                             .speed       = SDL_GENS_PER_SEC,
+                             .rule        = RULE_CONWAY,
+                             .max_period  = CYCLE_MAX_PERIOD,
+                             .density     = BATCH_DENSITY,
+                             .queue       = OUTPUT_QUEUE,
+                             .procs       = 1};
     argp_parse(&argp, argc, argv, 0, 0, &args);
     if (args.help) {
         argp_help(&argp, stdout, ARGP_HELP_STD_HELP, argv[0]);
@@ -311,78 +1135,137 @@ int main(int argc, char **argv) {
         if (strcmp(args.mode, "terminal") == 0) game_mode = GAME_TERMINAL;
         else if (strcmp(args.mode, "game") == 0) game_mode = GAME_SDL;
         else if (strcmp(args.mode, "gif") == 0) game_mode = GAME_GIF;
+        else if (strcmp(args.mode, "bench") == 0) game_mode = GAME_BENCH;
+        else if (strcmp(args.mode, "run") == 0) game_mode = GAME_RUN;
+        else if (strcmp(args.mode, "batch") == 0) game_mode = GAME_BATCH;
         else
             report_error_fatal("invalid mode '%s'\nAvailable modes: \n  "
-                               "terminal\n  game\n  gif\n",
+                               "terminal\n  game\n  gif\n  bench\n  run\n"
+                               "  batch\n",
                                args.mode);
     } else {  // Provide a default mode or show an error message.
         report_error_fatal("mode not specified: Use --mode to set the mode\n");
     }
+    if (args.pattern != NULL && args.resume == NULL && args.rule_text == NULL) {
+        struct Pattern_Error error;  // Run under the rule the pattern names.
+
+        if (pattern_rule(args.pattern, &args.rule, &error) < 0)
+            pattern_error_fatal(args.pattern, &error);
+    }
+    if (args.plane) {
+        if (game_mode == GAME_BENCH || game_mode == GAME_BATCH)
+            report_error_fatal("--plane does not run in --mode %s\n",
+                               args.mode);
+        if (args.resume != NULL || args.checkpoint_every > 0)
+            report_error_fatal("--plane cannot checkpoint or resume\n");
+        if (args.topology != TOPOLOGY_DEAD)
+            report_error_fatal("--plane has no edges for --topology\n");
+        if (args.rule.birth & 1)
+            report_error_fatal("--plane cannot run rules with B0\n");
+    }
+    if (args.procs > 1) {
+        if (game_mode != GAME_RUN)
+            report_error_fatal("--procs only runs in --mode run\n");
+        if (args.plane || args.checkpoint_every > 0 ||
+            args.topology != TOPOLOGY_DEAD)
+            report_error_fatal("--procs runs bounded boards with dead edges, "
+                               "without checkpoints\n");
+    }
     if (args.text_color != COLOR_DEFAULT) {  // TODO:
         // Use args.mode to set program's mode.
     }
+    if (args.profile != NULL &&
+        profile_open(args.profile, args.profile_every) != 0) {
+#ifdef GOL_PROFILE
+        report_error_fatal("could not open '%s': %s\n", args.profile,
+                           strerror(errno));
+#else
+        report_error_fatal("--profile needs a build with -DGOL_PROFILE "
+                           "(make profile)\n");
+#endif
+    }
     // —————————————————————————————————————————————————————————————————————————
     // GRID INITIALIZE to 0.
-    int choices_arr[]    = {0, 1};  // Fill grid with any of these values.
-    int grid[NROW][NCOL] = {0};
+    struct Board        board;
+    struct Checkpointer checkpoints;
 
-    for (int i = 0; i < NROW; i += 1) {  // Initialize all cells as dead.
-        for (int j = 0; j < NCOL; j += 1) { grid[i][j] = 0; }
+    if (args.resume != NULL) {  // The checkpoint decides the board size.
+        struct Checkpoint_Header header;
+        const char              *error;
+
+        if (checkpoint_read_header(args.resume, &header, &error) != 0)
+            report_error_fatal("%s: %s\n", args.resume, error);
+        args.rows = header.nrow;
+        args.cols = header.ncol;
+        if (args.rule_text == NULL)  // Carry on under the saved rule.
+            args.rule = (struct Rule){header.rule_birth, header.rule_survive};
+        if (!args.topology_given) args.topology = header.topology;
+    }
+    if (board_init(&board, args.rows, args.cols) != 0)  // All cells dead.
+        report_error_fatal("could not allocate %dx%d board\n", args.rows,
+                           args.cols);
+    board_set_rule(&board, args.rule);
+    board.topology = args.topology;
+    if (args.checkpoint_every > 0) {
+        const char *path = args.checkpoint_file != NULL ? args.checkpoint_file
+                                                        : CHECKPOINT_FILE;
+        if (checkpoint_start(&checkpoints, path, args.rows, args.cols) != 0)
+            report_error_fatal("could not start the checkpoint writer\n");
+        checkpointer     = &checkpoints;
+        checkpoint_every = args.checkpoint_every;
     }
+
+    if (args.threads > 1) {  // Workers persist across generations.
+        board.pool = pool_create(args.threads);
+        if (board.pool == NULL)
+            report_error_fatal("could not start %d threads\n", args.threads);
+    }
+    struct Grid *grid = &board.front;  // Always the current generation.
     // —————————————————————————————————————————————————————————————————————————
     // DECLARE & INITIALIZE MUTABLES.
-    int   new_grid[NROW][NCOL] = {0};
-    void *img                  = NULL;
+    void *img = NULL;
     // —————————————————————————————————————————————————————————————————————————
     // LOAD GAME.
     switch (game_mode) {
-    case GAME_GIF: {  // FIXME: TODO: make GIF work.
+    case GAME_GIF: {
         // —————————————————————————————————————————————————————————————————————
         // Load game map.
-        for (int i = 0; i < NROW; i += 1) {
-            for (int j = 0; j < NCOL; j += 1)
-                game_level_4(grid, choices_arr, i, j);
-        }
-        // —————————————————————————————————————————————————————————————————————
-        // Load and Setup GIF file.
-        const int total_frames = 60;
-        char     *out          = "output.gif";  // Setup GIF file for writing.
-        FILE     *gif_file     = fopen(out, "wb");
-        if (!gif_file) {
-            perror("Error opening file to write to\n");
-            return 1;
-        }
-        uint8_t header[]     = "GIF89a";  // Start of GIF.
-        uint8_t frame[]      = {0x2C, 0x00, 0x00, 0x00, 0x00, 0x64, 0x64, 0x00};
-        const uint16_t w_gif = NROW, h_gif = NCOL;  // gif width and height.
-        uint8_t        screen_desc[] = {(w_gif & 0xFF), ((w_gif >> 8) & 0xFF),
-                                        (h_gif & 0xFF), ((h_gif >> 8) & 0xFF),
-                                        (0xF7),         (0x00)};  // descriptor.
-        uint8_t        gce[]         = {0x21, 0xF9, 0x04, 0x00, 0x0A, 0x00};
-        uint8_t        trailer[]     = {0x3B};  // End of GIF.
-        write_bytes(gif_file, header, 6);
-        write_bytes(gif_file, screen_desc, 7);
+        load_game(&board, &args, game_level_4);
         // —————————————————————————————————————————————————————————————————————
-        // Render frames to GIF file.
-        for (int frame_num = 1; frame_num <= total_frames; frame_num += 1) {
-            update_buffer_and_img(img, new_grid, grid, frame_num);
-            write_bytes(gif_file, frame, 9);
-            uint8_t image_data[NROW * NCOL] = {0};
-            convert_grid_to_image(grid, image_data);
-            write_bytes(gif_file, image_data, sizeof(image_data));
-            if (0) write_bytes(gif_file, gce, 7);
+        // Stream frames to the output writer, which encodes and writes them
+        // on its own thread while the next generations are stepped.
+        struct Output  output;
+        const uint64_t total_frames =
+            args.generations > 0 ? args.generations : GIF_FRAMES;
+        const char    *out = args.output != NULL         ? args.output
+                             : args.format == OUTPUT_GIF ? "output.gif"
+                                                         : "-";
+        if (output_start(&output, args.format, out, grid->nrow, grid->ncol,
+                         GIF_FPS, args.queue, args.backpressure) != 0)
+            report_error_fatal("could not open '%s': %s\n", out,
+                               strerror(errno));
+        for (uint64_t frame_num = 1; frame_num <= total_frames;
+             frame_num += 1) {
+            update_buffer_and_img(img, &board, (int)frame_num);
+            PROFILE_BEGIN(PROFILE_FRAME_POST);
+            int err = output_post(&output, grid);
+            PROFILE_END(PROFILE_FRAME_POST);
+            if (err < 0) break;
         }
-        write_bytes(gif_file, trailer, 1);
-        fclose(gif_file);  // Cleanup.
+        int err = output_stop(&output);
+        if (err != 0)
+            report_error_fatal("could not write '%s': %s\n", out,
+                               strerror(err));
+        if (output.dropped > 0)
+            report_error("dropped %llu of %llu frames\n",
+                         (unsigned long long)output.dropped,
+                         (unsigned long long)total_frames);
         break;
     }
-    case GAME_SDL: {  // TODO:
+    case GAME_SDL: {
         // —————————————————————————————————————————————————————————————————————
         // Load game map.
-        for (int i = 0; i < NROW; i += 1) {
-            for (int j = 0; j < NCOL; j += 1)
-                game_level_3(grid, choices_arr, i, j);
-        }
+        load_game(&board, &args, game_level_3);
         // —————————————————————————————————————————————————————————————————————
         // Setup SDL.
         if (SDL_Init(SDL_INIT_VIDEO) != 0) {
@@ -396,7 +1279,7 @@ int main(int argc, char **argv) {
         }
         SDL_Window   *window;
         SDL_Renderer *renderer;
-        TTF_Font     *font;
+        TTF_Font     *font = NULL;
         window = SDL_CreateWindow("Game of Life", SDL_WINDOWPOS_CENTERED,
                                   SDL_WINDOWPOS_CENTERED, SCREEN_WIDTH,
                                   SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
@@ -406,63 +1289,151 @@ int main(int argc, char **argv) {
         }
         renderer = SDL_CreateRenderer(
             window, -1, SDL_RENDERER_PRESENTVSYNC | SDL_RENDERER_ACCELERATED);
+        if (renderer == NULL)  // Scaling one texture is cheap enough in software.
+            renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
         if (renderer == NULL) {
             SDL_DestroyWindow(window);
             SDL_Quit();
             report_error_fatal("%s\n", SDL_GetError());
         };
+        if (args.font != NULL && (font = TTF_OpenFont(args.font, 16)) == NULL)
+            report_error("could not open font '%s': %s\n", args.font,
+                         TTF_GetError());
+        // The board is one streaming texture, a pixel per cell, scaled up by
+        // the renderer. `pixels` mirrors it so that only the tiles changed
+        // by any step since the last frame (`redraw`) are repainted and
+        // uploaded.
+        SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "nearest");
+        const int    ntile  = board.tile_nrow * board.tile_ncol;
+        uint8_t     *redraw = malloc(ntile);
+        uint32_t    *pixels = malloc(sizeof(uint32_t) * grid->nrow * grid->ncol);
+        SDL_Texture *canvas = SDL_CreateTexture(
+            renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+            grid->ncol, grid->nrow);
+        SDL_Texture *overlay = NULL;
+        SDL_Rect     overlay_rect = {8, 8, 0, 0};
+        if (redraw == NULL || pixels == NULL || canvas == NULL) {
+            SDL_DestroyRenderer(renderer);
+            SDL_DestroyWindow(window);
+            SDL_Quit();
+            report_error_fatal("could not create canvas: %s\n",
+                               SDL_GetError());
+        }
+        memset(redraw, 1, ntile);  // Paint everything on the first frame.
         // —————————————————————————————————————————————————————————————————————
-        // Main game loop.
-        const int n_frames = 60, delay_ms = 100;
+        // Main game loop. The simulation follows its own clock at
+        // `args.speed` generations per second, whatever the display does.
+        // Each frame runs the steps that are due, within a time budget so
+        // input and drawing stay responsive; if stepping cannot keep up the
+        // clock is held back instead of piling up a backlog.
+        double   sim_start = now_seconds(), overlay_at = 0;
+        double   frame_secs = 0, step_secs = 0;  // smoothed.
+        uint64_t generation = 0;
+        int      running    = 1;
 
-        while (1) {
+        while (running) {
+            double    frame_start = now_seconds();
             SDL_Event event;
-            if (SDL_PollEvent(&event)) {  // Handle events.
-                if (event.type == SDL_QUIT) break;
+            while (SDL_PollEvent(&event)) {  // Handle events.
+                if (event.type == SDL_QUIT) running = 0;
+                if (event.type == SDL_KEYDOWN && plane != NULL) {
+                    // Pan the window an eighth of its size.
+                    const int dy = grid->nrow / 8 + 1, dx = grid->ncol / 8 + 1;
+                    switch (event.key.keysym.sym) {
+                    case SDLK_UP: view_top -= dy; break;
+                    case SDLK_DOWN: view_top += dy; break;
+                    case SDLK_LEFT: view_left -= dx; break;
+                    case SDLK_RIGHT: view_left += dx; break;
+                    default: continue;
+                    }
+                    show_plane(&board);
+                    memset(redraw, 1, ntile);
+                }
             }
             // —————————————————————————————————————————————————————————————————
-            // Game logic and rendering here.
-            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);  // bg color.
-            SDL_RenderClear(renderer);  // Clear cur target with the bg color.
             // Update game state.
-            for (int frame_num = 1; frame_num <= n_frames; frame_num += 1) {
-                update_buffer_and_img(img, new_grid, grid, frame_num);
+            uint64_t due  = (uint64_t)((frame_start - sim_start) * args.speed);
+            int      nstep = 0;
+            while (generation < due &&
+                   now_seconds() - frame_start < SDL_STEP_BUDGET_S) {
+                update_buffer_and_img(img, &board, (int)generation);
+                for (int t = 0; t < ntile; t += 1) redraw[t] |= board.dirty[t];
+                generation += 1;
+                nstep += 1;
             }
-            // Set the updated game state to renderer.
-            for (int x = 0; x < NROW; x += 1) {
-                for (int y = 0; y < NCOL; y += 1) {
-                    SDL_Rect cell_rect = {x * CELL_SIZE, y * CELL_SIZE,
-                                          CELL_SIZE, CELL_SIZE};
-                    switch (grid[x][y]) {
-                    case CELL_ALIVE:
-                        SDL_SetRenderDrawColor(renderer, 170, 170, 0, 255);
-                        break;
-                    case CELL_DEAD:
-                        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-                        break;
+            if (generation < due)  // Behind: slow the clock down to us.
+                sim_start = frame_start - (double)generation / args.speed;
+            if (nstep > 0)
+                step_secs = 0.9 * step_secs +
+                            0.1 * (now_seconds() - frame_start) / nstep;
+            // —————————————————————————————————————————————————————————————————
+            // Upload the changed tiles of the game state to the canvas.
+            SDL_Rect bounds;
+            PROFILE_BEGIN(PROFILE_SDL_PAINT);
+            if (paint_tiles(&board, redraw, pixels, &bounds) > 0) {
+                SDL_UpdateTexture(canvas, &bounds,
+                                  pixels + (size_t)bounds.y * grid->ncol +
+                                      bounds.x,
+                                  grid->ncol * sizeof(uint32_t));
+                memset(redraw, 0, ntile);
+            }
+            PROFILE_END(PROFILE_SDL_PAINT);
+            if (frame_start - overlay_at >= SDL_OVERLAY_S) {  // Timings.
+                char text[128];
+                snprintf(text, sizeof(text),
+                         "frame %.2f ms  step %.3f ms  gen %llu  %d gens/s",
+                         frame_secs * 1e3, step_secs * 1e3,
+                         (unsigned long long)board.generation, args.speed);
+                SDL_SetWindowTitle(window, text);
+                if (font != NULL) {
+                    SDL_Color    white   = {255, 255, 255, 255};
+                    SDL_Surface *surface = TTF_RenderText_Blended(font, text,
+                                                                  white);
+                    SDL_DestroyTexture(overlay);
+                    overlay = NULL;
+                    if (surface != NULL) {
+                        overlay = SDL_CreateTextureFromSurface(renderer, surface);
+                        overlay_rect.w = surface->w;
+                        overlay_rect.h = surface->h;
+                        SDL_FreeSurface(surface);
                     }
-                    SDL_RenderFillRect(renderer, &cell_rect);
                 }
+                overlay_at = frame_start;
             }
+            PROFILE_BEGIN(PROFILE_SDL_PRESENT);
+            SDL_Rect dest = fit_rect(renderer, grid->ncol, grid->nrow);
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);  // bg color.
+            SDL_RenderClear(renderer);  // Clear cur target with the bg color.
+            SDL_RenderCopy(renderer, canvas, NULL, &dest);
+            if (overlay != NULL)
+                SDL_RenderCopy(renderer, overlay, NULL, &overlay_rect);
             // —————————————————————————————————————————————————————————————————
             // Update screen with any rendering performed since previous call.
             SDL_RenderPresent(renderer);
-            SDL_Delay(delay_ms);
-        }  // while (1)
+            PROFILE_END(PROFILE_SDL_PRESENT);
+            PROBE1(sdl_frame, board.generation);
+            frame_secs = 0.9 * frame_secs + 0.1 * (now_seconds() - frame_start);
+            // Without vsync, hold the frame rate down; due steps batch up.
+            double idle = frame_start + SDL_FRAME_S - now_seconds();
+            if (idle > 0.001) SDL_Delay((Uint32)(idle * 1e3));
+        }  // while (running)
         // —————————————————————————————————————————————————————————————————————
         // Cleanup and exit.
+        free(redraw);
+        free(pixels);
+        SDL_DestroyTexture(overlay);
+        SDL_DestroyTexture(canvas);
+        if (font != NULL) TTF_CloseFont(font);
         SDL_DestroyRenderer(renderer);
         SDL_DestroyWindow(window);
+        TTF_Quit();
         SDL_Quit();
         break;
     }
     case GAME_TERMINAL: {
         // —————————————————————————————————————————————————————————————————————
         // Load game map.
-        for (int i = 0; i < NROW; i += 1) {
-            for (int j = 0; j < NCOL; j += 1)
-                game_level_3(grid, choices_arr, i, j);
-        }
+        load_game(&board, &args, game_level_3);
         // —————————————————————————————————————————————————————————————————————
         // Setup terminal animation.
         int        fps = (int)(120 / 10), animate_dur_secs = (int)(10 * 2.5);
@@ -471,27 +1442,53 @@ int main(int argc, char **argv) {
         float      interval_frames_s  = interval_frames_ms / 1000;
         useconds_t interval_frames_microsecond = interval_frames_ms * 1000;
         // —————————————————————————————————————————————————————————————————————
-        // Update state and render each frame.
+        // Update state and render each frame. Each frame only sends the
+        // cells the step changed, header included, in a single write.
+        struct Term_Renderer term;
+        if (term_init(&term, grid->nrow, grid->ncol, args.glyphs,
+                      TERM_HEADER_LINES + 1) != 0)
+            report_error_fatal("could not allocate terminal buffer\n");
+        term_draw(&term, &board);
         for (int frame_num = 1; frame_num <= n_frames; frame_num += 1) {
             usleep(interval_frames_microsecond);
-            term_clear_screen();
-            term_move_cursor(1, 1);
-            {  // Show animation dev information.
-                printf("%s", TEXT_COLOR_GREEN);
-                printf("delay(s)       %7.2f\n", interval_frames_s);
-                printf("duration(s)    %4d \n", animate_dur_secs);
-                printf("frames/sec     %4d\n", fps);
-                printf("frame          %4d/%d\n", frame_num, (int)n_frames);
-                printf("%s\n", RESET_COLOR);
-            }
-            update_buffer_and_img(img, new_grid, grid, frame_num);
-            printf("%s", TEXT_COLOR_YELLOW);
-            print_grid(new_grid);
-            printf("%s\n", RESET_COLOR);
+            // Show animation dev information.
+            term_printf(&term,
+                        TEXT_COLOR_GREEN "delay(s)       %7.2f\n"
+                                         "duration(s)    %4d \n"
+                                         "frames/sec     %4d\n"
+                                         "frame          %4d/%d\n" RESET_COLOR,
+                        interval_frames_s, animate_dur_secs, fps, frame_num,
+                        (int)n_frames);
+            update_buffer_and_img(img, &board, frame_num);
+            PROFILE_BEGIN(PROFILE_TERM_DRAW);
+            term_draw(&term, &board);
+            PROFILE_END(PROFILE_TERM_DRAW);
+            term_flush(&term);
         }
+        term_printf(&term, "\033[%d;1H\n",
+                    TERM_HEADER_LINES + 1 +
+                        (grid->nrow + term.cell_h - 1) / term.cell_h);
+        term_flush(&term);
+        term_free(&term);
         break;
     }
+    case GAME_BENCH: run_bench(&args, board.pool); break;
+    case GAME_RUN:
+        load_game(&board, &args, game_level_4);
+        run_generations(&board, &args);
+        break;
+    case GAME_BATCH: run_batch(&args, board.pool); break;
     default: report_error_fatal("unexpected game mode %d", game_mode);
     }
+    if (checkpointer != NULL) {  // Let the last checkpoint land.
+        int err = checkpoint_stop(checkpointer);
+        if (err != 0)
+            report_error("could not write checkpoint: %s\n", strerror(err));
+    }
+    if (profile_close() != 0)
+        report_error("could not write profile '%s'\n", args.profile);
+    if (plane != NULL) plane_free(plane);
+    pool_destroy(board.pool);
+    board_free(&board);
     return 0;
 }
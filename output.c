@@ -0,0 +1,226 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 Asynchronous frame output		<output.c>
+///
+
+#include "output.h"
+#include "profile.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// —————————————————————————————————————————————————————————————————————————————
+// RAW FRAMES.
+
+// Bytes of 0 or 255 for the 8 cells of each byte value, lowest bit first.
+static uint64_t expand[256];
+
+static void init_expand(void) {
+    for (int v = 0; v < 256; v += 1) {
+        uint64_t bytes = 0;
+
+        for (int b = 0; b < 8; b += 1) {
+            if (v >> b & 1) bytes |= (uint64_t)0xFF << (8 * b);
+        }
+        expand[v] = bytes;  // Little-endian: byte b is cell b.
+    }
+}
+
+// Write all of `data`, past interruptions and short writes.
+static int write_all(int fd, const uint8_t *data, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += n;
+        size -= n;
+    }
+    return 0;
+}
+
+// Expand `grid` into the pixels of the raw frame and write it.
+static int write_raw(struct Output *out, const struct Grid *grid) {
+    uint8_t *pixel = out->frame + out->frame_header;
+
+    for (int i = 0; i < grid->nrow; i += 1) {
+        const uint8_t *row = (const uint8_t *)grid_row(grid, i);
+        int            j   = 0;
+
+        for (; j + 8 <= grid->ncol; j += 8, pixel += 8)
+            memcpy(pixel, &expand[row[j / 8]], 8);
+        for (; j < grid->ncol; j += 1)
+            *pixel++ = grid_get(grid, i, j) ? 0xFF : 0;
+    }
+    return write_all(out->fd, out->frame, out->frame_size);
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// WRITER THREAD.
+
+static void *writer_main(void *arg) {
+    struct Output *out   = arg;
+    uint64_t       taken = 0;
+
+    for (;;) {
+        while (sem_wait(&out->nready) != 0) continue;  // EINTR.
+        if (taken == __atomic_load_n(&out->posted, __ATOMIC_ACQUIRE)) break;
+        taken += 1;
+
+        const struct Grid *grid = &out->slots[out->tail];
+        if (out->error == 0) {  // After a failure, only drain.
+            int err = out->format == OUTPUT_GIF ? gif_add_frame(out->gif, grid)
+                                                : write_raw(out, grid);
+
+            if (err != 0)
+                __atomic_store_n(&out->error,
+                                 out->format == OUTPUT_GIF ? EIO : errno,
+                                 __ATOMIC_RELAXED);
+            out->written += 1;
+            PROBE1(frame_written, out->written);
+        }
+        out->tail = (out->tail + 1) % out->nslot;
+        sem_post(&out->nfree);
+    }
+    return NULL;
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// LIFETIME.
+
+// Open the file and set up the encoder. Returns 0, or -1 with errno set.
+static int open_sink(struct Output *out, const char *path, int nrow, int ncol,
+                     int fps) {
+    char header[64];
+    int  len = 0;
+
+    if (out->format == OUTPUT_GIF) {
+        out->gif = malloc(sizeof(*out->gif));  // Too big for the stack.
+        if (out->gif == NULL) return -1;
+        if (gif_open(out->gif, path, nrow, ncol, 100 / fps) != 0) {
+            if (errno == 0) errno = EINVAL;
+            free(out->gif);
+            out->gif = NULL;
+            return -1;
+        }
+        return 0;
+    }
+    out->fd = strcmp(path, "-") == 0
+                  ? STDOUT_FILENO
+                  : open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out->fd < 0) return -1;
+    if (out->format == OUTPUT_Y4M) {
+        len = snprintf(header, sizeof(header),
+                       "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 Cmono\n", ncol, nrow,
+                       fps);
+        if (write_all(out->fd, (const uint8_t *)header, len) != 0) return -1;
+        len = snprintf(header, sizeof(header), "FRAME\n");
+    } else {
+        len = snprintf(header, sizeof(header), "P5\n%d %d\n255\n", ncol, nrow);
+    }
+    out->frame_header = len;
+    out->frame_size   = len + (size_t)nrow * ncol;
+    out->frame        = malloc(out->frame_size);
+    if (out->frame == NULL) return -1;
+    memcpy(out->frame, header, len);
+    return 0;
+}
+
+static void close_sink(struct Output *out) {
+    if (out->gif != NULL) {
+        if (gif_close(out->gif) != 0 && out->error == 0) out->error = EIO;
+        free(out->gif);
+        out->gif = NULL;
+    }
+    if (out->fd > STDOUT_FILENO && close(out->fd) != 0 && out->error == 0)
+        out->error = errno;
+    out->fd = -1;
+    free(out->frame);
+    out->frame = NULL;
+}
+
+int output_start(struct Output *out, enum Output_Format format,
+                 const char *path, int nrow, int ncol, int fps, int nslot,
+                 enum Output_Backpressure backpressure) {
+    memset(out, 0, sizeof(*out));
+    out->format       = format;
+    out->backpressure = backpressure;
+    out->nslot        = nslot;
+    out->fd           = -1;
+    init_expand();
+    errno = 0;
+    if (open_sink(out, path, nrow, ncol, fps) != 0) {
+        int err = errno;
+
+        close_sink(out);
+        errno = err;
+        return -1;
+    }
+    out->slots = calloc(nslot, sizeof(*out->slots));
+    for (int s = 0; out->slots != NULL && s < nslot; s += 1) {
+        if (grid_init(&out->slots[s], nrow, ncol) != 0) {
+            out->nslot = s;  // Free what there is.
+            break;
+        }
+    }
+    if (out->slots == NULL || out->nslot < nslot) goto fail;
+    sem_init(&out->nfree, 0, nslot);
+    sem_init(&out->nready, 0, 0);
+    if (pthread_create(&out->thread, NULL, writer_main, out) != 0) {
+        sem_destroy(&out->nfree);
+        sem_destroy(&out->nready);
+        goto fail;
+    }
+    return 0;
+
+fail:
+    for (int s = 0; out->slots != NULL && s < out->nslot; s += 1)
+        grid_free(&out->slots[s]);
+    free(out->slots);
+    close_sink(out);
+    errno = ENOMEM;
+    return -1;
+}
+
+int output_post(struct Output *out, const struct Grid *grid) {
+    if (__atomic_load_n(&out->error, __ATOMIC_RELAXED) != 0) return -1;
+    if (out->backpressure == OUTPUT_DROP) {
+        if (sem_trywait(&out->nfree) != 0) {
+            out->dropped += 1;
+            PROBE1(frame_dropped, out->dropped);
+            return 1;
+        }
+    } else {
+        while (sem_wait(&out->nfree) != 0) continue;  // EINTR.
+    }
+    grid_copy(&out->slots[out->head], grid);
+    out->head = (out->head + 1) % out->nslot;
+    __atomic_add_fetch(&out->posted, 1, __ATOMIC_RELEASE);
+    sem_post(&out->nready);
+    return 0;
+}
+
+int output_stop(struct Output *out) {
+    sem_post(&out->nready);  // One more than posted: stop once drained.
+    pthread_join(out->thread, NULL);
+    sem_destroy(&out->nfree);
+    sem_destroy(&out->nready);
+    for (int s = 0; s < out->nslot; s += 1) grid_free(&out->slots[s]);
+    free(out->slots);
+    close_sink(out);
+    return out->error;
+}
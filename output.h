@@ -0,0 +1,84 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 Asynchronous frame output		<output.h>
+///
+
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdint.h>
+
+#include "gif.h"
+#include "grid.h"
+
+// —————————————————————————————————————————————————————————————————————————————
+// FRAME QUEUE.
+//
+// The simulation hands each frame to a ring of `nslot` grids allocated up
+// front, and a writer thread encodes and writes them in order, so stepping
+// never waits on the encoder or the disk. Frames stay bit-packed in the
+// ring, an eighth of a byte per cell, and only the writer expands them.
+//
+// There is one producer and one consumer, so each side owns its end of the
+// ring and two semaphores count the free and the filled slots; neither
+// side takes a lock. When the ring is full, `OUTPUT_BLOCK` waits for the
+// writer and `OUTPUT_DROP` skips the frame.
+//
+// Raw formats write every frame whole with one `write`, 8 bits per cell,
+// 255 for alive: PGM as a stream of binary "P5" images, or YUV4MPEG2 with
+// only a luma plane, e.g. for `ffmpeg -i - out.mp4`.
+enum Output_Format {
+    OUTPUT_GIF,
+    OUTPUT_PGM,
+    OUTPUT_Y4M,
+};
+
+enum Output_Backpressure {
+    OUTPUT_BLOCK,
+    OUTPUT_DROP,
+};
+
+struct Output {
+    enum Output_Format       format;
+    enum Output_Backpressure backpressure;
+    int                      nslot;
+    struct Grid             *slots;
+    int                      head;     // next slot to fill, producer only.
+    int                      tail;     // next slot to write, writer only.
+    uint64_t                 posted;   // frames queued, read by the writer.
+    sem_t                    nfree;    // slots the producer may fill.
+    sem_t                    nready;   // frames queued, plus one to stop.
+    pthread_t                thread;
+    struct Gif_Writer       *gif;
+    int                      fd;       // raw formats.
+    uint8_t                 *frame;    // one raw frame, header included.
+    size_t                   frame_header, frame_size;  // bytes.
+    uint64_t                 written;  // frames, by the writer.
+    uint64_t                 dropped;  // frames, by the producer.
+    int                      error;    // errno of the first failed write.
+};
+
+// Open `path` ("-" for stdout with the raw formats) for a `nrow` x `ncol`
+// animation at `fps` frames per second and start the writer. Returns 0, or
+// -1 with errno set.
+int output_start(struct Output *out, enum Output_Format format,
+                 const char *path, int nrow, int ncol, int fps, int nslot,
+                 enum Output_Backpressure backpressure);
+// Queue a copy of `grid` as the next frame. Returns 0, 1 if it was dropped,
+// or -1 if writing has failed.
+int output_post(struct Output *out, const struct Grid *grid);
+// Write every queued frame, stop the writer and close the file. Returns 0,
+// or the errno of a failed write.
+int output_stop(struct Output *out);
+
+#endif  // OUTPUT_H
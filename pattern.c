@@ -0,0 +1,285 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 RLE and plaintext pattern reader		<pattern.c>
+///
+
+#include "pattern.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define PATTERN_MAX_RUN 1000000000  // Longer run counts are surely corrupt.
+
+struct Parser {
+    const char           *p, *end;
+    const char           *line_start;
+    int                   line;
+    struct Grid          *grid;
+    long                  row, col;  // Next cell, in grid coordinates.
+    long                  left;      // Column each pattern row starts at.
+    struct Pattern_Error *error;
+};
+
+// —————————————————————————————————————————————————————————————————————————————
+// HELPERS.
+
+static int parse_fail(struct Parser *parser, const char *format, ...) {
+    va_list args;
+
+    parser->error->line = parser->line;
+    parser->error->col  = (int)(parser->p - parser->line_start) + 1;
+    va_start(args, format);
+    vsnprintf(parser->error->message, sizeof(parser->error->message), format,
+              args);
+    va_end(args);
+
+    return -1;
+}
+
+static void next_line(struct Parser *parser) {
+    const char *eol = memchr(parser->p, '\n', parser->end - parser->p);
+
+    parser->p          = eol != NULL ? eol + 1 : parser->end;
+    parser->line_start = parser->p;
+    parser->line      += 1;
+}
+
+// Skip blank lines and lines starting with `comment`, unless it is 0, and
+// the spaces before whatever comes next.
+static void skip_lines(struct Parser *parser, char comment) {
+    while (parser->p < parser->end) {
+        const char *q = parser->p;
+
+        while (q < parser->end && (*q == ' ' || *q == '\t' || *q == '\r'))
+            q += 1;
+        if (q < parser->end && *q != '\n' && (comment == 0 || *q != comment)) {
+            parser->p = q;
+            return;
+        }
+        next_line(parser);
+    }
+}
+
+// Set `n` live cells from (row, col) rightwards, dropping any off the grid.
+static void set_run(struct Grid *grid, long row, long col, long n) {
+    long j_begin = col < 0 ? 0 : col;
+    long j_end   = col + n > grid->ncol ? grid->ncol : col + n;
+
+    if (row < 0 || row >= grid->nrow || j_begin >= j_end) return;
+
+    uint64_t *cells = grid_row(grid, (int)row);
+    int       w     = (int)(j_begin >> 6), w_last = (int)((j_end - 1) >> 6);
+    uint64_t  first = ~0ull << (j_begin & 63);
+    uint64_t  last  = ~0ull >> (63 - ((j_end - 1) & 63));
+
+    if (w == w_last) {
+        cells[w] |= first & last;
+        return;
+    }
+    cells[w] |= first;
+    for (w += 1; w < w_last; w += 1) cells[w] = ~0ull;
+    cells[w_last] |= last;
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// FORMATS.
+
+// Parse the `rule = ...` field of the RLE header at `parser->p` into
+// `*rule`. Returns 1, 0 if the header names no rule, or -1 if the rule is
+// not one `rule_parse` takes.
+static int parse_rule_field(struct Parser *parser, struct Rule *rule) {
+    const char *eol = memchr(parser->p, '\n', parser->end - parser->p);
+    const char *q   = parser->p;
+    char        text[64];
+
+    if (eol == NULL) eol = parser->end;
+    for (;; q += 1) {  // Find "rule", then its value past '='.
+        if (eol - q < 4) return 0;
+        if (memcmp(q, "rule", 4) == 0) break;
+    }
+    for (q += 4; q < eol && (*q == ' ' || *q == '\t' || *q == '='); q += 1)
+        continue;
+
+    const char *value = q;
+    while (q < eol && *q != ',' && *q != ' ' && *q != '\t' && *q != '\r')
+        q += 1;
+    parser->p = value;
+    if ((size_t)(q - value) >= sizeof(text))
+        return parse_fail(parser, "rule too long");
+    memcpy(text, value, q - value);
+    text[q - value] = '\0';
+    if (rule_parse(text, rule) != 0)
+        return parse_fail(parser, "unsupported rule '%s'", text);
+    return 1;
+}
+
+static int parse_rle(struct Parser *parser) {
+    skip_lines(parser, '#');
+    if (parser->p < parser->end && *parser->p == 'x') next_line(parser);
+
+    // The hot loop keeps its state in locals: stores to the grid could
+    // alias the parser's fields and force reloads on every run.
+    const char  *p = parser->p, *end = parser->end;
+    struct Grid *grid = parser->grid;
+    long         row = parser->row, col = parser->col, count = 0;
+
+    for (; p < end; p += 1) {
+        const unsigned digit = (unsigned char)*p - '0';
+
+        if (digit < 10) {
+            count = count * 10 + digit;
+            if (count > PATTERN_MAX_RUN) break;
+            continue;
+        }
+        const long n = count > 0 ? count : 1;
+
+        switch (*p) {
+        case 'b':
+        case '.': col += n; break;
+        case 'o':
+            set_run(grid, row, col, n);
+            col += n;
+            break;
+        case '$':
+            row += n;
+            col  = parser->left;
+            break;
+        case '!': return 0;
+        case '\n':
+            parser->line      += 1;
+            parser->line_start = p + 1;
+            continue;  // A count may be wrapped onto the next line.
+        case ' ':
+        case '\t':
+        case '\r': continue;
+        default: goto fail;
+        }
+        count = 0;
+    }
+fail:
+    parser->p = p;
+    if (p == end)
+        return parse_fail(parser, "missing '!' at the end of the pattern");
+    if (count > PATTERN_MAX_RUN) return parse_fail(parser, "run too long");
+    if ((*p >= 'A' && *p <= 'Z') || (*p >= 'p' && *p <= 'y'))
+        return parse_fail(parser, "unsupported cell state '%c'", *p);
+    return parse_fail(parser, "unexpected '%c'", *p);
+}
+
+static int parse_cells(struct Parser *parser) {
+    while (parser->p < parser->end) {
+        if (*parser->p == '!') {  // Comment.
+            next_line(parser);
+            continue;
+        }
+        for (; parser->p < parser->end && *parser->p != '\n'; parser->p += 1) {
+            const char *run = parser->p;
+
+            switch (*parser->p) {
+            case '.': parser->col += 1; break;
+            case 'O':
+            case '*':
+                while (parser->p + 1 < parser->end &&
+                       (parser->p[1] == 'O' || parser->p[1] == '*'))
+                    parser->p += 1;
+                set_run(parser->grid, parser->row, parser->col,
+                        parser->p - run + 1);
+                parser->col += parser->p - run + 1;
+                break;
+            case '\r': break;
+            default: return parse_fail(parser, "unexpected '%c'", *parser->p);
+            }
+        }
+        if (parser->p < parser->end) next_line(parser);
+        parser->row += 1;
+        parser->col  = parser->left;
+    }
+    return 0;
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// LOADING.
+
+// Map `path` for reading. Returns the mapping, or NULL with `error` filled
+// in.
+static const char *map_pattern(const char *path, size_t *size,
+                               struct Pattern_Error *error) {
+    struct stat st;
+    int         fd = open(path, O_RDONLY);
+
+    error->line = error->col = 0;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        snprintf(error->message, sizeof(error->message), "%s",
+                 strerror(errno));
+        if (fd >= 0) close(fd);
+        return NULL;
+    }
+    if (!S_ISREG(st.st_mode) || st.st_size == 0) {
+        snprintf(error->message, sizeof(error->message), "%s",
+                 S_ISREG(st.st_mode) ? "empty file" : "not a regular file");
+        close(fd);
+        return NULL;
+    }
+    const char *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // The mapping stays valid.
+    if (data == MAP_FAILED) {
+        snprintf(error->message, sizeof(error->message), "%s",
+                 strerror(errno));
+        return NULL;
+    }
+    *size = st.st_size;
+    return data;
+}
+
+int pattern_load(struct Grid *grid, const char *path, int top, int left,
+                 struct Pattern_Error *error) {
+    size_t      size;
+    const char *data = map_pattern(path, &size, error);
+
+    if (data == NULL) return -1;
+    madvise((void *)data, size, MADV_SEQUENTIAL);
+
+    struct Parser parser = {data, data + size, data, 1, grid, top,
+                            left, left, error};
+    skip_lines(&parser, 0);
+
+    const char first  = parser.p < parser.end ? *parser.p : '\0';
+    int        result = first == '!' || first == '.' || first == 'O' ||
+                                first == '*'
+                            ? parse_cells(&parser)
+                            : parse_rle(&parser);
+    munmap((void *)data, size);
+
+    return result;
+}
+
+int pattern_rule(const char *path, struct Rule *rule,
+                 struct Pattern_Error *error) {
+    size_t      size;
+    const char *data = map_pattern(path, &size, error);
+    int         result = 0;
+
+    if (data == NULL) return -1;
+
+    struct Parser parser = {data, data + size, data, 1, NULL, 0, 0, 0, error};
+    skip_lines(&parser, '#');
+    if (parser.p < parser.end && *parser.p == 'x')
+        result = parse_rule_field(&parser, rule);
+    munmap((void *)data, size);
+
+    return result;
+}
@@ -0,0 +1,47 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 RLE and plaintext pattern reader		<pattern.h>
+///
+
+#ifndef PATTERN_H
+#define PATTERN_H
+
+#include "grid.h"
+
+// —————————————————————————————————————————————————————————————————————————————
+// PATTERN FILES.
+//
+// Reads the two common Life pattern formats:
+//
+// * RLE: `#` comment lines, a `x = W, y = H[, rule = ...]` header, then
+//   runs like `3o2b$` ending with `!`. `pattern_rule` reads the rule.
+// * Plaintext (.cells): `!` comment lines, then one row per line of `.`
+//   for dead and `O` for alive cells.
+//
+// The file is memory-mapped and parsed in one pass straight into the grid,
+// with runs of live cells set a word at a time. Cells are OR-ed into the
+// grid, and cells falling outside it are dropped. Blank lines before the
+// pattern are skipped.
+struct Pattern_Error {
+    int  line, col;  // 1-based position in the file, 0 if not applicable.
+    char message[128];
+};
+
+// Load `path` with its top left cell at (top, left), which may be negative.
+// Returns 0, or -1 with `error` filled in.
+int pattern_load(struct Grid *grid, const char *path, int top, int left,
+                 struct Pattern_Error *error);
+// Read the rule the RLE header of `path` names into `*rule`. Returns 1, 0
+// if it names none or `path` is plaintext, or -1 with `error` filled in.
+int pattern_rule(const char *path, struct Rule *rule,
+                 struct Pattern_Error *error);
+
+#endif  // PATTERN_H
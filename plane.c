@@ -0,0 +1,443 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 Unbounded sparse plane		<plane.c>
+///
+
+#include "plane.h"
+#include "pool.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define PLANE_NO_TILE    UINT32_MAX
+#define PLANE_TASK_TILES 16  // tiles per pool task.
+
+// Floor of `v / PLANE_TILE`, also for negative `v`.
+static int64_t tile_of(int64_t v) {
+    return v >= 0 ? v / PLANE_TILE : -((-v + PLANE_TILE - 1) / PLANE_TILE);
+}
+
+static struct Plane_Tile *tile_at(const struct Plane *plane, uint32_t id) {
+    return &plane->chunks[id / PLANE_CHUNK][id % PLANE_CHUNK];
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// TILE MAP.
+//
+// Linear probing over a power of two slots, kept at most half full. Removal
+// shifts the rest of the probe run back instead of leaving tombstones, so
+// lookups never wade through the tiles of past generations.
+
+static size_t slot_of(const struct Plane *plane, int64_t ty, int64_t tx) {
+    uint64_t h = (uint64_t)ty * 0x9E3779B97F4A7C15ull ^
+                 (uint64_t)tx * 0xC2B2AE3D27D4EB4Full;
+
+    h ^= h >> 32;
+    return (size_t)h & plane->slot_mask;
+}
+
+static struct Plane_Tile *plane_find(const struct Plane *plane, int64_t ty,
+                                     int64_t tx) {
+    for (size_t s = slot_of(plane, ty, tx);; s = (s + 1) & plane->slot_mask) {
+        uint32_t id = plane->slots[s];
+
+        if (id == 0) return NULL;
+        struct Plane_Tile *tile = tile_at(plane, id - 1);
+        if (tile->ty == ty && tile->tx == tx) return tile;
+    }
+}
+
+static void map_put(struct Plane *plane, uint32_t id) {
+    const struct Plane_Tile *tile = tile_at(plane, id);
+    size_t                   s    = slot_of(plane, tile->ty, tile->tx);
+
+    while (plane->slots[s] != 0) s = (s + 1) & plane->slot_mask;
+    plane->slots[s] = id + 1;
+}
+
+// Double the slots and put every tile back. Returns 0, or -1.
+static int map_grow(struct Plane *plane) {
+    size_t    nslot = (plane->slot_mask + 1) * 2;
+    uint32_t *slots = calloc(nslot, sizeof(*slots));
+
+    if (slots == NULL) return -1;
+    free(plane->slots);
+    plane->slots     = slots;
+    plane->slot_mask = nslot - 1;
+    for (size_t k = 0; k < plane->nlive; k += 1)
+        map_put(plane, plane->live[k]);
+    return 0;
+}
+
+static void map_remove(struct Plane *plane, const struct Plane_Tile *tile) {
+    size_t hole = slot_of(plane, tile->ty, tile->tx);
+
+    while (tile_at(plane, plane->slots[hole] - 1) != tile)
+        hole = (hole + 1) & plane->slot_mask;
+    // Pull back each later tile of the run whose home slot is not after the
+    // hole, as probing for it from home would stop at the hole.
+    for (size_t s = (hole + 1) & plane->slot_mask; plane->slots[s] != 0;
+         s = (s + 1) & plane->slot_mask) {
+        const struct Plane_Tile *next = tile_at(plane, plane->slots[s] - 1);
+        size_t home = slot_of(plane, next->ty, next->tx);
+        size_t dist = (s - home) & plane->slot_mask;
+
+        if (dist >= ((s - hole) & plane->slot_mask)) {
+            plane->slots[hole] = plane->slots[s];
+            hole               = s;
+        }
+    }
+    plane->slots[hole] = 0;
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// TILE POOL.
+
+// Hand out an empty, unchanged tile at (ty, tx), which must not be in the
+// map yet.
+// Returns NULL and marks the plane failed if out of memory.
+static struct Plane_Tile *tile_new(struct Plane *plane, int64_t ty,
+                                   int64_t tx) {
+    uint32_t id;
+
+    if ((plane->nlive + 1) * 2 > plane->slot_mask + 1 && map_grow(plane) != 0)
+        goto fail;
+    if (plane->nlive == plane->live_cap) {
+        size_t    cap  = plane->live_cap * 2;
+        uint32_t *live = realloc(plane->live, cap * sizeof(*live));
+
+        if (live == NULL) goto fail;
+        plane->live     = live;
+        plane->live_cap = cap;
+    }
+    if (plane->free_head != PLANE_NO_TILE) {
+        id               = plane->free_head;
+        plane->free_head = tile_at(plane, id)->index;
+    } else {
+        if (plane->ntile == plane->nchunk * PLANE_CHUNK) {
+            struct Plane_Tile **chunks =
+                realloc(plane->chunks, (plane->nchunk + 1) * sizeof(*chunks));
+
+            if (chunks == NULL) goto fail;
+            plane->chunks = chunks;
+            chunks[plane->nchunk] =
+                aligned_alloc(64, PLANE_CHUNK * sizeof(struct Plane_Tile));
+            if (chunks[plane->nchunk] == NULL) goto fail;
+            plane->nchunk += 1;
+        }
+        id = plane->ntile++;
+    }
+
+    struct Plane_Tile *tile = tile_at(plane, id);
+    memset(tile->rows, 0, sizeof(tile->rows));
+    tile->ty      = ty;
+    tile->tx      = tx;
+    tile->hash    = 0;
+    tile->changed = 0;
+    tile->stepped = 0;
+    tile->index   = plane->nlive;
+    plane->live[plane->nlive++] = id;
+    map_put(plane, id);
+    return tile;
+
+fail:
+    plane->failed = 1;
+    return NULL;
+}
+
+// Take `tile` out of the map and the live list and onto the free list.
+static void tile_release(struct Plane *plane, struct Plane_Tile *tile) {
+    uint32_t id   = plane->live[tile->index];
+    uint32_t last = plane->live[--plane->nlive];
+
+    map_remove(plane, tile);
+    plane->live[tile->index]    = last;
+    tile_at(plane, last)->index = tile->index;
+    tile->index                 = plane->free_head;
+    plane->free_head            = id;
+}
+
+static struct Plane_Tile *tile_get(struct Plane *plane, int64_t ty,
+                                   int64_t tx) {
+    struct Plane_Tile *tile = plane_find(plane, ty, tx);
+
+    return tile != NULL ? tile : tile_new(plane, ty, tx);
+}
+
+// Hash of row `r` of a tile holding `bits`. Like the board's tile hash,
+// every row is mixed with its position and empty rows add nothing, so an
+// empty plane hashes to 0 and rows and tiles combine by XOR.
+static uint64_t row_hash(const struct Plane_Tile *tile, int r, uint64_t bits) {
+    const uint64_t where = (uint64_t)tile->ty * 0xD6E8FEB86659FD93ull ^
+                           (uint64_t)tile->tx * 0xFF51AFD7ED558CCDull;
+    uint64_t       h     = bits ^ (where + r) * 0x9E3779B97F4A7C15ull;
+
+    h ^= h >> 31;  // splitmix64's finaliser.
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBull;
+    h ^= h >> 31;
+    return bits != 0 ? h : 0;
+}
+
+static uint64_t tile_hash(const struct Plane_Tile *tile) {
+    uint64_t hash = 0;
+
+    for (int r = 0; r < PLANE_TILE; r += 1)
+        hash ^= row_hash(tile, r, tile->rows[r]);
+    return hash;
+}
+
+// OR `bits` into row `r` of tile (ty, tx), keeping the hashes up to date.
+// Returns 0, or -1 if out of memory.
+static int tile_or_row(struct Plane *plane, int64_t ty, int64_t tx, int r,
+                       uint64_t bits) {
+    struct Plane_Tile *tile;
+    uint64_t           h;
+
+    if (bits == 0) return 0;  // No empty tiles.
+    if ((tile = tile_get(plane, ty, tx)) == NULL) return -1;
+    h              = row_hash(tile, r, tile->rows[r]);
+    tile->rows[r] |= bits;
+    h             ^= row_hash(tile, r, tile->rows[r]);
+    tile->hash    ^= h;
+    plane->hash   ^= h;
+    tile->changed  = 1;
+    return 0;
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// PLANE STORAGE.
+
+int plane_init(struct Plane *plane, struct Rule rule) {
+    // Under a B0 rule the whole empty plane comes alive.
+    if (rule.birth & 1) return -1;
+    memset(plane, 0, sizeof(*plane));
+    plane->free_head = PLANE_NO_TILE;
+    plane->live_cap  = 64;
+    plane->live      = malloc(plane->live_cap * sizeof(*plane->live));
+    plane->slot_mask = 127;
+    plane->slots     = calloc(plane->slot_mask + 1, sizeof(*plane->slots));
+    plane->rule      = rule;
+    if (plane->live == NULL || plane->slots == NULL) {
+        plane_free(plane);
+        return -1;
+    }
+    return 0;
+}
+
+void plane_free(struct Plane *plane) {
+    for (size_t c = 0; c < plane->nchunk; c += 1) free(plane->chunks[c]);
+    free(plane->chunks);
+    free(plane->live);
+    free(plane->slots);
+    memset(plane, 0, sizeof(*plane));
+}
+
+int plane_or_row(struct Plane *plane, int64_t y, int64_t x, uint64_t bits) {
+    const int64_t ty    = tile_of(y);
+    const int64_t tx    = tile_of(x);
+    const int     r     = (int)(y - ty * PLANE_TILE);
+    const int     shift = (int)(x - tx * PLANE_TILE);
+
+    if (tile_or_row(plane, ty, tx, r, bits << shift) != 0) return -1;
+    if (shift != 0)
+        return tile_or_row(plane, ty, tx + 1, r, bits >> (64 - shift));
+    return 0;
+}
+
+int plane_from_grid(struct Plane *plane, const struct Grid *grid, int64_t top,
+                    int64_t left) {
+    for (int i = 0; i < grid->nrow; i += 1) {
+        const uint64_t *row = grid_row(grid, i);
+
+        for (int w = 0; w < grid->nword; w += 1) {
+            if (plane_or_row(plane, top + i, left + (int64_t)w * 64, row[w]) !=
+                0)
+                return -1;
+        }
+    }
+    return 0;
+}
+
+void plane_view(const struct Plane *plane, struct Grid *grid, int64_t top,
+                int64_t left) {
+    memset(grid->cells, 0, grid_size(grid->nrow, grid->ncol));
+    for (size_t k = 0; k < plane->nlive; k += 1) {
+        const struct Plane_Tile *tile = tile_at(plane, plane->live[k]);
+        const int64_t y0 = tile->ty * PLANE_TILE - top;
+        int64_t       c  = tile->tx * PLANE_TILE - left;
+
+        if (y0 <= -PLANE_TILE || y0 >= grid->nrow || c <= -PLANE_TILE ||
+            c >= grid->ncol)
+            continue;
+        const int drop = c < 0 ? (int)-c : 0;  // columns left of the window.
+        if (c < 0) c = 0;
+        const int w = (int)(c >> 6), shift = (int)(c & 63);
+
+        for (int r = 0; r < PLANE_TILE; r += 1) {
+            if (y0 + r < 0 || y0 + r >= grid->nrow) continue;
+            uint64_t *row  = grid_row(grid, (int)(y0 + r));
+            uint64_t  bits = tile->rows[r] >> drop;
+
+            row[w] |= bits << shift;
+            if (shift != 0 && w + 1 < grid->nword)
+                row[w + 1] |= bits >> (64 - shift);
+        }
+    }
+    for (int i = 0; i < grid->nrow; i += 1)  // Nothing past the last column.
+        grid_row(grid, i)[grid->nword - 1] &= grid_tail_mask(grid);
+}
+
+uint64_t plane_population(const struct Plane *plane) {
+    uint64_t count = 0;
+
+    for (size_t k = 0; k < plane->nlive; k += 1) {
+        const struct Plane_Tile *tile = tile_at(plane, plane->live[k]);
+
+        for (int r = 0; r < PLANE_TILE; r += 1)
+            count += __builtin_popcountll(tile->rows[r]);
+    }
+    return count;
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// STEPPING.
+//
+// A tile is stepped as a one-word-wide grid whose pads hold its neighbours'
+// edges, so the rule kernels of <grid.c> do the work unchanged: the pad
+// words take the whole rows of the tiles west and east, and the pad rows
+// the facing rows of the tiles north and south.
+
+// Make room for births just past the live edges of the tiles in the plane.
+// Returns 0, or -1 if out of memory.
+static int plane_grow(struct Plane *plane) {
+    const size_t n = plane->nlive;  // Tiles added here are empty.
+
+    for (size_t k = 0; k < n; k += 1) {
+        const struct Plane_Tile *tile = tile_at(plane, plane->live[k]);
+        uint64_t                 any  = 0;
+
+        for (int r = 0; r < PLANE_TILE; r += 1) any |= tile->rows[r];
+        for (int dy = -1; dy <= 1; dy += 1) {
+            uint64_t edge = dy < 0   ? tile->rows[0]
+                            : dy > 0 ? tile->rows[PLANE_TILE - 1]
+                                     : any;
+
+            for (int dx = -1; dx <= 1; dx += 1) {
+                int need = dx < 0 ? edge & 1 : dx > 0 ? edge >> 63 : edge != 0;
+
+                if (!need || (dx == 0 && dy == 0)) continue;
+                if (tile_get(plane, tile->ty + dy, tile->tx + dx) == NULL)
+                    return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+// Step tiles [first, first + PLANE_TASK_TILES) of the live list into their
+// `next` rows, skipping those with no change in or around them.
+static void step_tiles(void *ctx, int task) {
+    const struct Plane *plane = ctx;
+    uint64_t            in[(PLANE_TILE + 2) * 3], out[(PLANE_TILE + 2) * 3];
+    struct Grid         src = {PLANE_TILE, PLANE_TILE, 1, 3, in};
+    struct Grid         dst = {PLANE_TILE, PLANE_TILE, 1, 3, out};
+    const size_t        first = (size_t)task * PLANE_TASK_TILES;
+    const size_t        last  = first + PLANE_TASK_TILES < plane->nlive
+                                    ? first + PLANE_TASK_TILES
+                                    : plane->nlive;
+
+    for (size_t k = first; k < last; k += 1) {
+        struct Plane_Tile       *tile = tile_at(plane, plane->live[k]);
+        const struct Plane_Tile *around[3][3];
+        int                      active = tile->changed;
+
+        for (int dy = -1; dy <= 1; dy += 1) {
+            for (int dx = -1; dx <= 1; dx += 1) {
+                const struct Plane_Tile *nb =
+                    plane_find(plane, tile->ty + dy, tile->tx + dx);
+
+                around[dy + 1][dx + 1] = nb;
+                active |= nb != NULL && nb->changed;
+            }
+        }
+        tile->stepped = active;
+        if (!active) continue;
+
+        for (int i = -1; i <= PLANE_TILE; i += 1) {
+            const int row = i < 0 ? 0 : i < PLANE_TILE ? 1 : 2;
+            const int r   = i < 0 ? PLANE_TILE - 1 : i < PLANE_TILE ? i : 0;
+
+            for (int c = 0; c < 3; c += 1) {
+                const struct Plane_Tile *nb = around[row][c];
+
+                in[(i + 1) * 3 + c] = nb != NULL ? nb->rows[r] : 0;
+            }
+        }
+        update_state(&dst, &src, plane->rule);
+        for (int r = 0; r < PLANE_TILE; r += 1)
+            tile->next[r] = out[(r + 1) * 3 + 1];
+    }
+}
+
+int plane_step(struct Plane *plane) {
+    if (plane->failed || plane_grow(plane) != 0) return -1;
+
+    const int ntask = (int)((plane->nlive + PLANE_TASK_TILES - 1) /
+                            PLANE_TASK_TILES);
+    if (plane->pool != NULL) {
+        pool_run(plane->pool, ntask, step_tiles, plane);
+    } else {
+        for (int t = 0; t < ntask; t += 1) step_tiles(plane, t);
+    }
+
+    for (size_t k = 0; k < plane->nlive; k += 1) {
+        struct Plane_Tile *tile    = tile_at(plane, plane->live[k]);
+        uint64_t           flipped = 0;
+
+        if (tile->stepped) {
+            for (int r = 0; r < PLANE_TILE; r += 1)
+                flipped |= tile->next[r] ^ tile->rows[r];
+        }
+        tile->changed = flipped != 0;
+        if (!tile->changed) continue;
+        memcpy(tile->rows, tile->next, sizeof(tile->rows));
+        plane->hash ^= tile->hash;
+        tile->hash   = tile_hash(tile);
+        plane->hash ^= tile->hash;
+    }
+
+    // Free the tiles that are empty now. One that just emptied wakes its
+    // neighbours, which will no longer find it to see that it changed.
+    for (size_t k = plane->nlive; k-- > 0;) {
+        struct Plane_Tile *tile = tile_at(plane, plane->live[k]);
+        uint64_t           any  = 0;
+
+        // Unchanged, so still live, or empty room next to a settled edge.
+        if (!tile->stepped) continue;
+        for (int r = 0; r < PLANE_TILE; r += 1) any |= tile->rows[r];
+        if (any != 0) continue;
+        if (tile->changed) {
+            for (int dy = -1; dy <= 1; dy += 1) {
+                for (int dx = -1; dx <= 1; dx += 1) {
+                    struct Plane_Tile *nb =
+                        plane_find(plane, tile->ty + dy, tile->tx + dx);
+
+                    if (nb != NULL) nb->changed = 1;
+                }
+            }
+        }
+        tile_release(plane, tile);
+    }
+    plane->generation += 1;
+    return 0;
+}
@@ -0,0 +1,92 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 Unbounded sparse plane		<plane.h>
+///
+
+#ifndef PLANE_H
+#define PLANE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "grid.h"
+
+// —————————————————————————————————————————————————————————————————————————————
+// UNBOUNDED PLANE.
+//
+// Only tiles of PLANE_TILE x PLANE_TILE cells with live cells in them are
+// kept, one word per tile row, in an open-addressing hash map keyed by tile
+// coordinates. Tile (ty, tx) covers rows [64 ty, 64 ty + 64) and columns
+// [64 tx, 64 tx + 64), and coordinates may be negative.
+//
+// Before each step the plane grows an empty tile next to every tile with
+// live cells on that edge, since births may spill into it, and after the
+// step tiles that were recomputed and ended up empty are freed. Like the
+// board's tiles, a tile is only recomputed when it or a neighbour changed
+// in the last step, so memory and step time follow the live tiles, not the
+// bounding box. A new tile counts as unchanged, so the room next to a
+// settled pattern is neither stepped nor freed and grown again.
+//
+// Tiles come from chunks of PLANE_CHUNK tiles that are never moved, so
+// tile pointers stay valid while the map grows, and freed tiles go on a
+// free list for reuse.
+#define PLANE_TILE  64
+#define PLANE_CHUNK 1024  // tiles per allocation.
+
+struct Pool;
+
+struct Plane_Tile {
+    int64_t  ty, tx;
+    uint64_t rows[PLANE_TILE];  // current generation, bit j of row i.
+    uint64_t next[PLANE_TILE];  // next generation while stepping.
+    uint64_t hash;              // of `rows`, 0 when empty.
+    uint32_t index;    // in `live`, or the next free tile once freed.
+    uint8_t  changed;  // in the last step.
+    uint8_t  stepped;  // recomputed in this step.
+};
+
+struct Plane {
+    struct Plane_Tile **chunks;
+    size_t              nchunk;
+    uint32_t            free_head;  // free tiles, chained through `index`.
+    uint32_t            ntile;      // tiles handed out, free ones included.
+    uint32_t           *live;       // ids of the tiles in use.
+    size_t              nlive, live_cap;
+    uint32_t           *slots;      // map: tile id + 1, or 0 if empty.
+    size_t              slot_mask;
+    struct Rule         rule;
+    struct Pool        *pool;        // NULL steps on the calling thread.
+    uint64_t            generation;
+    uint64_t            hash;        // XOR of the tile hashes.
+    int                 failed;      // ran out of memory.
+};
+
+int  plane_init(struct Plane *plane, struct Rule rule);
+void plane_free(struct Plane *plane);
+
+// OR in 64 cells of row `y`, bit j of `bits` at column `x + j`. Returns 0,
+// or -1 if out of memory.
+int plane_or_row(struct Plane *plane, int64_t y, int64_t x, uint64_t bits);
+// OR the live cells of `grid` in with its top left cell at (top, left).
+// Returns 0, or -1 if out of memory.
+int plane_from_grid(struct Plane *plane, const struct Grid *grid, int64_t top,
+                    int64_t left);
+// Copy the window of the plane with its top left cell at (top, left) into
+// `grid`, replacing what was there.
+void plane_view(const struct Plane *plane, struct Grid *grid, int64_t top,
+                int64_t left);
+
+// Advance one generation. Returns 0, or -1 if out of memory.
+int plane_step(struct Plane *plane);
+
+uint64_t plane_population(const struct Plane *plane);
+
+#endif  // PLANE_H
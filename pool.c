@@ -0,0 +1,198 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 Persistent worker pool		<pool.c>
+///
+
+#include "pool.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+// —————————————————————————————————————————————————————————————————————————————
+// POOL STATE.
+
+// Tasks [next, end) not yet claimed from one worker's chunk. Owner and
+// thieves both claim with a fetch-add, so a task is never run twice. Padded
+// to a cache line so workers do not fight over each other's counters.
+struct Chunk {
+    _Alignas(64) atomic_int next;
+    int end;
+};
+
+// A phase-counting barrier. Unlike `pthread_barrier_t` its head count can
+// be lowered, which lets `pool_create` back out of a half-started pool.
+struct Barrier {
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    int             count;    // Threads that must arrive.
+    int             arrived;
+    unsigned        phase;
+};
+
+struct Worker {
+    struct Pool *pool;
+    pthread_t    thread;
+    int          id;
+};
+
+struct Pool {
+    int            nthread;
+    struct Worker *workers;  // nthread - 1 threads, the caller is #0.
+    struct Barrier start;    // Released when a job is posted.
+    struct Barrier finish;   // Released when every chunk is drained.
+    struct Chunk  *chunks;
+    Pool_Task      fn;       // NULL asks the workers to exit.
+    void          *ctx;
+};
+
+// —————————————————————————————————————————————————————————————————————————————
+// BARRIER.
+
+static void barrier_init(struct Barrier *barrier, int count) {
+    pthread_mutex_init(&barrier->lock, NULL);
+    pthread_cond_init(&barrier->cond, NULL);
+    barrier->count   = count;
+    barrier->arrived = 0;
+    barrier->phase   = 0;
+}
+
+static void barrier_destroy(struct Barrier *barrier) {
+    pthread_mutex_destroy(&barrier->lock);
+    pthread_cond_destroy(&barrier->cond);
+}
+
+static void barrier_wait(struct Barrier *barrier) {
+    pthread_mutex_lock(&barrier->lock);
+    unsigned phase = barrier->phase;
+    if (++barrier->arrived >= barrier->count) {
+        barrier->arrived = 0;
+        barrier->phase += 1;
+        pthread_cond_broadcast(&barrier->cond);
+    } else {
+        while (phase == barrier->phase)
+            pthread_cond_wait(&barrier->cond, &barrier->lock);
+    }
+    pthread_mutex_unlock(&barrier->lock);
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// WORK STEALING.
+
+static int chunk_claim(struct Chunk *chunk) {
+    if (atomic_load_explicit(&chunk->next, memory_order_relaxed) >= chunk->end)
+        return -1;
+    int task = atomic_fetch_add_explicit(&chunk->next, 1, memory_order_relaxed);
+    return task < chunk->end ? task : -1;
+}
+
+// Drain worker `id`'s own chunk, then steal from the others in turn.
+static void work(struct Pool *pool, int id) {
+    for (int k = 0; k < pool->nthread; k += 1) {
+        struct Chunk *chunk = &pool->chunks[(id + k) % pool->nthread];
+        int           task;
+
+        while ((task = chunk_claim(chunk)) >= 0) pool->fn(pool->ctx, task);
+    }
+}
+
+static void *worker_main(void *arg) {
+    struct Pool *pool = ((struct Worker *)arg)->pool;
+    int          id   = ((struct Worker *)arg)->id;
+
+    while (1) {
+        barrier_wait(&pool->start);
+        if (pool->fn == NULL) break;
+        work(pool, id);
+        barrier_wait(&pool->finish);
+    }
+    return NULL;
+}
+
+// Release and join the first `nstarted` workers.
+static void pool_stop(struct Pool *pool, int nstarted) {
+    pthread_mutex_lock(&pool->start.lock);
+    pool->start.count = nstarted + 1;  // Only those are waiting, plus us.
+    pthread_mutex_unlock(&pool->start.lock);
+    pool->fn = NULL;  // Workers see it after the start barrier and exit.
+    if (nstarted > 0) barrier_wait(&pool->start);
+    for (int i = 1; i <= nstarted; i += 1) {
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// POOL LIFETIME.
+
+struct Pool *pool_create(int nthread) {
+    struct Pool *pool = calloc(1, sizeof(*pool));
+
+    if (pool == NULL) return NULL;
+    pool->nthread = nthread < 1 ? 1 : nthread;
+    pool->workers = calloc(pool->nthread, sizeof(*pool->workers));
+    pool->chunks  = aligned_alloc(64, pool->nthread * sizeof(*pool->chunks));
+    if (pool->workers == NULL || pool->chunks == NULL) {
+        free(pool->workers);
+        free(pool->chunks);
+        free(pool);
+        return NULL;
+    }
+    for (int i = 0; i < pool->nthread; i += 1) {
+        atomic_init(&pool->chunks[i].next, 0);
+        pool->chunks[i].end = 0;
+    }
+    barrier_init(&pool->start, pool->nthread);
+    barrier_init(&pool->finish, pool->nthread);
+    for (int i = 1; i < pool->nthread; i += 1) {
+        pool->workers[i].pool = pool;
+        pool->workers[i].id   = i;
+        if (pthread_create(&pool->workers[i].thread, NULL, worker_main,
+                           &pool->workers[i]) != 0) {
+            pool->nthread = i;
+            pool_destroy(pool);
+            return NULL;
+        }
+    }
+    return pool;
+}
+
+void pool_destroy(struct Pool *pool) {
+    if (pool == NULL) return;
+    pool_stop(pool, pool->nthread - 1);
+    barrier_destroy(&pool->start);
+    barrier_destroy(&pool->finish);
+    free(pool->workers);
+    free(pool->chunks);
+    free(pool);
+}
+
+int pool_size(const struct Pool *pool) { return pool->nthread; }
+
+void pool_run(struct Pool *pool, int ntask, Pool_Task fn, void *ctx) {
+    if (ntask <= 0) return;
+    if (pool->nthread == 1) {  // No one to hand out to.
+        for (int task = 0; task < ntask; task += 1) fn(ctx, task);
+        return;
+    }
+    // Deal tasks out in contiguous chunks so neighbouring stripes stay on
+    // one worker unless it falls behind. The barrier publishes the chunks.
+    for (int i = 0; i < pool->nthread; i += 1) {
+        atomic_store_explicit(&pool->chunks[i].next,
+                              (int)((long)ntask * i / pool->nthread),
+                              memory_order_relaxed);
+        pool->chunks[i].end = (int)((long)ntask * (i + 1) / pool->nthread);
+    }
+    pool->fn  = fn;
+    pool->ctx = ctx;
+    barrier_wait(&pool->start);
+    work(pool, 0);
+    barrier_wait(&pool->finish);
+}
@@ -0,0 +1,37 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 Persistent worker pool		<pool.h>
+///
+
+#ifndef POOL_H
+#define POOL_H
+
+// —————————————————————————————————————————————————————————————————————————————
+// WORKER POOL.
+//
+// A fixed set of threads that sleep at a barrier between jobs. Each job is a
+// range of task indices which is dealt out to the workers in contiguous
+// chunks; a worker that drains its own chunk steals from the others.
+struct Pool;
+
+typedef void (*Pool_Task)(void *ctx, int task);
+
+// Start a pool of `nthread` workers, the calling thread counted as one.
+// Returns NULL when a thread or the memory cannot be had.
+struct Pool *pool_create(int nthread);
+void         pool_destroy(struct Pool *pool);
+int          pool_size(const struct Pool *pool);
+
+// Run `fn(ctx, task)` for every task in [0, ntask) and return once all of
+// them finished. The caller works on the job too.
+void pool_run(struct Pool *pool, int ntask, Pool_Task fn, void *ctx);
+
+#endif  // POOL_H
@@ -0,0 +1,208 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 Phase timers, counters and probes		<profile.c>
+///
+
+#include "profile.h"
+
+#ifdef GOL_PROFILE
+
+    #include <stdio.h>
+    #include <string.h>
+    #include <time.h>
+
+    #define PROFILE_BUCKETS 48    // log2 of nanoseconds, up to about 39 hours.
+    #define PROFILE_ROWS    4096  // CSV rows buffered between writes.
+
+static const char *phase_names[PROFILE_PHASES] = {
+    "step",       "load",      "checkpoint", "frame_post",
+    "term_draw",  "term_write", "sdl_paint", "sdl_present",
+};
+
+struct Phase_Stats {
+    uint64_t count, total_ns, min_ns, max_ns;
+};
+
+struct Profile_Row {
+    uint64_t generation, population, changed;
+    uint64_t ns[PROFILE_PHASES];  // spent since the row before.
+};
+
+static struct {
+    const char        *path;
+    FILE              *csv;  // open for the whole run, or NULL for JSON.
+    uint64_t           every;
+    uint64_t           ngen;  // generations counted.
+    struct Phase_Stats phase[PROFILE_PHASES];
+    uint64_t           since[PROFILE_PHASES];
+    uint64_t           step_histogram[PROFILE_BUCKETS];
+    uint64_t           generation, population, changed;  // latest.
+    uint64_t           changed_total;
+    struct Profile_Row rows[PROFILE_ROWS];
+    int                nrow;
+    int                error;
+} profile;
+
+// —————————————————————————————————————————————————————————————————————————————
+// TIMERS.
+
+uint64_t profile_now(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+void profile_add(enum Profile_Phase phase, uint64_t ns) {
+    struct Phase_Stats *stats = &profile.phase[phase];
+
+    if (stats->count == 0 || ns < stats->min_ns) stats->min_ns = ns;
+    if (ns > stats->max_ns) stats->max_ns = ns;
+    stats->count          += 1;
+    stats->total_ns       += ns;
+    profile.since[phase]  += ns;
+    if (phase == PROFILE_STEP) {
+        int bucket = ns == 0 ? 0 : 64 - __builtin_clzll(ns);
+
+        if (bucket >= PROFILE_BUCKETS) bucket = PROFILE_BUCKETS - 1;
+        profile.step_histogram[bucket] += 1;
+    }
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// REPORTS.
+
+static void write_csv_rows(void) {
+    for (int r = 0; r < profile.nrow; r += 1) {
+        const struct Profile_Row *row = &profile.rows[r];
+
+        fprintf(profile.csv, "%llu,%llu,%llu",
+                (unsigned long long)row->generation,
+                (unsigned long long)row->population,
+                (unsigned long long)row->changed);
+        for (int p = 0; p < PROFILE_PHASES; p += 1) {
+            fprintf(profile.csv, ",%llu", (unsigned long long)row->ns[p]);
+        }
+        fputc('\n', profile.csv);
+    }
+    profile.nrow = 0;
+    if (fflush(profile.csv) != 0) profile.error = 1;
+}
+
+static void write_json(void) {
+    FILE *json = fopen(profile.path, "w");
+
+    if (json == NULL) {
+        profile.error = 1;
+        return;
+    }
+    fprintf(json,
+            "{\"generation\": %llu, \"generations_counted\": %llu, "
+            "\"population\": %llu, \"changed\": %llu, "
+            "\"changed_mean\": %.3f,\n \"phases\": {\n",
+            (unsigned long long)profile.generation,
+            (unsigned long long)profile.ngen,
+            (unsigned long long)profile.population,
+            (unsigned long long)profile.changed,
+            profile.ngen > 0 ? (double)profile.changed_total / profile.ngen
+                             : 0.0);
+    for (int p = 0; p < PROFILE_PHASES; p += 1) {
+        const struct Phase_Stats *s = &profile.phase[p];
+
+        fprintf(json,
+                "  \"%s\": {\"count\": %llu, \"total_ns\": %llu, "
+                "\"mean_ns\": %.1f, \"min_ns\": %llu, \"max_ns\": %llu}%s\n",
+                phase_names[p], (unsigned long long)s->count,
+                (unsigned long long)s->total_ns,
+                s->count > 0 ? (double)s->total_ns / s->count : 0.0,
+                (unsigned long long)s->min_ns, (unsigned long long)s->max_ns,
+                p + 1 < PROFILE_PHASES ? "," : "");
+    }
+    // Bucket k counts steps that took [2^(k-1), 2^k) nanoseconds.
+    fprintf(json, " },\n \"step_histogram\": [");
+    const char *sep = "";
+    for (int k = 0; k < PROFILE_BUCKETS; k += 1) {
+        if (profile.step_histogram[k] == 0) continue;
+        fprintf(json, "%s\n  {\"below_ns\": %llu, \"count\": %llu}", sep,
+                (unsigned long long)1 << k,
+                (unsigned long long)profile.step_histogram[k]);
+        sep = ",";
+    }
+    fprintf(json, "\n ]}\n");
+    if (fclose(json) != 0) profile.error = 1;
+}
+
+static void profile_report(void) {
+    if (profile.csv != NULL) write_csv_rows();
+    else write_json();
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// LIFETIME.
+
+int profile_open(const char *path, uint64_t every) {
+    size_t len = strlen(path);
+
+    profile.path  = path;
+    profile.every = every;
+    if (len >= 4 && strcmp(path + len - 4, ".csv") == 0) {
+        profile.csv = fopen(path, "w");
+        if (profile.csv == NULL) return -1;
+        fprintf(profile.csv, "generation,population,changed");
+        for (int p = 0; p < PROFILE_PHASES; p += 1) {
+            fprintf(profile.csv, ",%s_ns", phase_names[p]);
+        }
+        fputc('\n', profile.csv);
+    }
+    return 0;
+}
+
+void profile_generation(const struct Board *board) {
+    const struct Grid *now = &board->front, *before = &board->back;
+    uint64_t           population = 0, changed = 0;
+
+    if (profile.path == NULL) return;
+    for (int i = 0; i < now->nrow; i += 1) {
+        const uint64_t *a = grid_row(now, i), *b = grid_row(before, i);
+
+        for (int w = 0; w < now->nword; w += 1) {
+            population += __builtin_popcountll(a[w]);
+            changed    += __builtin_popcountll(a[w] ^ b[w]);
+        }
+    }
+    profile.generation     = board->generation;
+    profile.population     = population;
+    profile.changed        = changed;
+    profile.changed_total += changed;
+    profile.ngen          += 1;
+    if (profile.csv != NULL) {
+        struct Profile_Row *row = &profile.rows[profile.nrow++];
+
+        row->generation = board->generation;
+        row->population = population;
+        row->changed    = changed;
+        memcpy(row->ns, profile.since, sizeof(row->ns));
+        if (profile.nrow == PROFILE_ROWS) write_csv_rows();
+    }
+    memset(profile.since, 0, sizeof(profile.since));
+    if (profile.every > 0 && profile.ngen % profile.every == 0)
+        profile_report();
+}
+
+int profile_close(void) {
+    if (profile.path == NULL) return 0;
+    profile_report();
+    if (profile.csv != NULL && fclose(profile.csv) != 0) profile.error = 1;
+    profile.path = NULL;
+    return profile.error ? -1 : 0;
+}
+
+#endif  // GOL_PROFILE
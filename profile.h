@@ -0,0 +1,98 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 Phase timers, counters and probes		<profile.h>
+///
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+
+#include "grid.h"
+
+// —————————————————————————————————————————————————————————————————————————————
+// PROBES.
+//
+// Static USDT probes under the provider "gameoflife", compiled in whenever
+// <sys/sdt.h> is there, with or without GOL_PROFILE. An unused probe is a
+// single nop, so release builds keep them and perf or bpftrace can attach
+// to a running process, e.g.
+//
+//     bpftrace -e 'usdt:./gameoflife:gameoflife:step_done { @[arg0] = 1 }'
+#if defined(__has_include)
+    #if __has_include(<sys/sdt.h>)
+        #include <sys/sdt.h>
+        #define GOL_HAVE_SDT 1
+    #endif
+#endif
+
+#ifdef GOL_HAVE_SDT
+    #define PROBE1(name, a)    DTRACE_PROBE1(gameoflife, name, a)
+    #define PROBE2(name, a, b) DTRACE_PROBE2(gameoflife, name, a, b)
+#else
+    #define PROBE1(name, a)    ((void)0)
+    #define PROBE2(name, a, b) ((void)0)
+#endif
+
+// —————————————————————————————————————————————————————————————————————————————
+// PHASE TIMERS AND COUNTERS.
+//
+// Compiled in only with -DGOL_PROFILE (`make profile`); otherwise the
+// macros are empty and the functions do nothing. Timers read the monotonic
+// clock around each phase on the main thread, where the output writer's
+// thread only fires probes, and keep a count, total, min and max per
+// phase, plus a log2 histogram of step latency. After every
+// generation the population and the number of cells that flipped are
+// counted too, which costs a pass over the board.
+//
+// `profile_open(path, every)` reports to `path` on `profile_close` and every
+// `every` generations if that is not 0. A path ending in ".csv" gets one row
+// per generation: its counters and the time spent in each phase since the
+// row before. Any other path gets a JSON summary, rewritten at each report.
+enum Profile_Phase {
+    PROFILE_STEP,
+    PROFILE_LOAD,        // seeding: pattern, checkpoint or level.
+    PROFILE_CHECKPOINT,  // snapshot copy; the write is on its own thread.
+    PROFILE_FRAME_POST,  // copy into the output queue, any wait included.
+    PROFILE_TERM_DRAW,
+    PROFILE_TERM_WRITE,
+    PROFILE_SDL_PAINT,    // dirty tiles into pixels and the texture.
+    PROFILE_SDL_PRESENT,  // render copy and present.
+    PROFILE_PHASES,
+};
+
+#ifdef GOL_PROFILE
+    #define PROFILE_BEGIN(phase) const uint64_t profile_start_##phase = profile_now()
+    #define PROFILE_END(phase)                                                 \
+        profile_add(phase, profile_now() - profile_start_##phase)
+
+uint64_t profile_now(void);  // nanoseconds.
+void     profile_add(enum Profile_Phase phase, uint64_t ns);
+int      profile_open(const char *path, uint64_t every);
+// Count the generation `board` just stepped into, and report if it is due.
+void     profile_generation(const struct Board *board);
+// Report once more and close. Returns 0, or -1 if a report failed.
+int      profile_close(void);
+#else
+    #define PROFILE_BEGIN(phase) ((void)0)
+    #define PROFILE_END(phase)   ((void)0)
+
+static inline int  profile_open(const char *path, uint64_t every) {
+    (void)path, (void)every;
+    return -1;
+}
+static inline void profile_generation(const struct Board *board) {
+    (void)board;
+}
+static inline int  profile_close(void) { return 0; }
+#endif
+
+#endif  // PROFILE_H
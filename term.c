@@ -0,0 +1,216 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 Diffing terminal renderer		<term.c>
+///
+
+#include "term.h"
+#include "profile.h"
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TERM_CELL_COLOR  "\x1b[33m"  // yellow.
+#define TERM_RESET_COLOR "\x1b[0m"
+#define TERM_MOVE_MAX    24    // "\033[<row>;<col>H" with 10 digit numbers.
+#define TERM_GLYPH_MAX   3     // bytes: " o " or one UTF-8 character.
+#define TERM_TEXT_MAX    4096  // room for `term_printf` and colours.
+
+// —————————————————————————————————————————————————————————————————————————————
+// OUTPUT BUFFER.
+
+int term_flush(struct Term_Renderer *term) {
+    size_t done = 0;
+
+    PROBE1(term_flush, term->len);
+    PROFILE_BEGIN(PROFILE_TERM_WRITE);
+    while (done < term->len) {
+        ssize_t n = write(STDOUT_FILENO, term->buf + done, term->len - done);
+
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            term->len = 0;
+            PROFILE_END(PROFILE_TERM_WRITE);
+            return -1;
+        }
+        done += n;
+    }
+    term->len = 0;
+    PROFILE_END(PROFILE_TERM_WRITE);
+    return 0;
+}
+
+// Make room for `size` more bytes. The buffer fits a full screen redrawn
+// row by row, so this only flushes early when changes are scattered enough
+// that cursor moves outweigh the glyphs.
+static void term_reserve(struct Term_Renderer *term, size_t size) {
+    if (term->len + size > term->cap) term_flush(term);
+}
+
+static void term_append(struct Term_Renderer *term, const char *data,
+                        size_t size) {
+    term_reserve(term, size);
+    memcpy(term->buf + term->len, data, size);
+    term->len += size;
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// RENDERER LIFETIME.
+
+int term_init(struct Term_Renderer *term, int nrow, int ncol,
+              enum Term_Glyphs glyphs, int top) {
+    term->glyphs = glyphs;
+    switch (glyphs) {
+    case TERM_GLYPHS_HALF: term->cell_w = 1, term->cell_h = 2; break;
+    case TERM_GLYPHS_BRAILLE: term->cell_w = 2, term->cell_h = 4; break;
+    default: term->cell_w = 1, term->cell_h = 1; break;
+    }
+    term->char_w  = glyphs == TERM_GLYPHS_CELL ? 3 : 1;
+    term->top     = top;
+    term->cur_row = 0;
+    term->cur_col = 0;
+    term->full    = 1;
+    term->len     = 0;
+
+    size_t char_rows = (nrow + term->cell_h - 1) / term->cell_h;
+    size_t char_cols = (ncol + term->cell_w - 1) / term->cell_w;
+    term->cap = char_rows * (TERM_MOVE_MAX + char_cols * TERM_GLYPH_MAX) +
+                TERM_TEXT_MAX;
+    term->buf = malloc(term->cap);
+    if (term->buf == NULL) return -1;
+    if (grid_init(&term->shown, nrow, ncol) != 0) {  // A cleared screen.
+        free(term->buf);
+        return -1;
+    }
+    term_append(term, "\033[2J", 4);
+
+    return 0;
+}
+
+void term_free(struct Term_Renderer *term) {
+    grid_free(&term->shown);
+    free(term->buf);
+}
+
+void term_printf(struct Term_Renderer *term, const char *format, ...) {
+    va_list args;
+
+    term_reserve(term, TERM_TEXT_MAX);
+    term_append(term, "\033[H", 3);
+    va_start(args, format);
+    size_t room = term->cap - term->len;
+    int    n    = vsnprintf(term->buf + term->len, room, format, args);
+    va_end(args);
+    if (n > 0) term->len += (size_t)n < room ? (size_t)n : room - 1;
+    term->cur_row = 0;  // Unknown: the text may wrap.
+}
+
+// —————————————————————————————————————————————————————————————————————————————
+// DRAWING.
+
+// Queue the character whose top left cell is (i, j).
+static void term_put_char(struct Term_Renderer *term, const struct Grid *grid,
+                          int i, int j) {
+    const int row = term->top + i / term->cell_h;
+    const int col = 1 + (j / term->cell_w) * term->char_w;
+    char      out[TERM_MOVE_MAX + TERM_GLYPH_MAX];
+    int       len = 0;
+    unsigned  bits = 0;  // cell (r, c) of the character at bit r * 2 + c.
+
+    for (int r = 0; r < term->cell_h && i + r < grid->nrow; r += 1) {
+        for (int c = 0; c < term->cell_w; c += 1) {
+            bits |= (unsigned)grid_get(grid, i + r, j + c) << (r * 2 + c);
+        }
+    }
+    if (row != term->cur_row || col != term->cur_col)
+        len = snprintf(out, sizeof(out), "\033[%d;%dH", row, col);
+    switch (term->glyphs) {
+    case TERM_GLYPHS_CELL:
+        memcpy(out + len, bits ? " o " : "   ", 3);
+        len += 3;
+        break;
+    case TERM_GLYPHS_HALF:  // U+2580 upper, U+2584 lower, U+2588 full.
+        if (bits == 0) {
+            out[len++] = ' ';
+        } else {
+            static const char tail[4] = {0, 0x80, 0x84, 0x88};
+            out[len++] = 0xE2;
+            out[len++] = 0x96;
+            out[len++] = tail[(bits & 1) | (bits >> 2 & 1) << 1];
+        }
+        break;
+    case TERM_GLYPHS_BRAILLE: {  // U+2800 plus one bit per dot.
+        static const unsigned char dot[8] = {0x01, 0x08, 0x02, 0x10,
+                                             0x04, 0x20, 0x40, 0x80};
+        unsigned dots = 0;
+
+        for (int k = 0; k < 8; k += 1) {
+            if (bits >> k & 1) dots |= dot[k];
+        }
+        out[len++] = 0xE2;
+        out[len++] = 0xA0 | dots >> 6;
+        out[len++] = 0x80 | (dots & 0x3F);
+        break;
+    }
+    }
+    term_append(term, out, len);
+    term->cur_row = row;
+    term->cur_col = col + term->char_w;
+}
+
+// Queue the characters that changed in one tile and record them as shown.
+// Tiles are whole characters high and wide, so none straddles two tiles.
+static void term_draw_tile(struct Term_Renderer *term, const struct Grid *grid,
+                           int trow, int tcol) {
+    const int w_begin = tcol * TILE_WORDS;
+    const int w_end   = w_begin + TILE_WORDS < grid->nword ? w_begin + TILE_WORDS
+                                                           : grid->nword;
+    const int i_end   = (trow + 1) * TILE_ROWS < grid->nrow
+                            ? (trow + 1) * TILE_ROWS
+                            : grid->nrow;
+    const uint64_t char_mask = (1ull << term->cell_w) - 1;
+
+    for (int i = trow * TILE_ROWS; i < i_end; i += term->cell_h) {
+        const int nr = i + term->cell_h < i_end ? term->cell_h : i_end - i;
+
+        for (int w = w_begin; w < w_end; w += 1) {
+            uint64_t diff = 0;
+
+            for (int r = 0; r < nr; r += 1) {
+                diff |= grid_row(grid, i + r)[w] ^ grid_row(&term->shown, i + r)[w];
+            }
+            while (diff != 0) {
+                int shift = __builtin_ctzll(diff) / term->cell_w * term->cell_w;
+
+                diff &= ~(char_mask << shift);
+                term_put_char(term, grid, i, 64 * w + shift);
+            }
+            for (int r = 0; r < nr; r += 1) {
+                grid_row(&term->shown, i + r)[w] = grid_row(grid, i + r)[w];
+            }
+        }
+    }
+}
+
+void term_draw(struct Term_Renderer *term, const struct Board *board) {
+    term_append(term, TERM_CELL_COLOR, sizeof(TERM_CELL_COLOR) - 1);
+    for (int trow = 0; trow < board->tile_nrow; trow += 1) {
+        for (int tcol = 0; tcol < board->tile_ncol; tcol += 1) {
+            if (term->full || board_tile_dirty(board, trow, tcol))
+                term_draw_tile(term, &board->front, trow, tcol);
+        }
+    }
+    term_append(term, TERM_RESET_COLOR, sizeof(TERM_RESET_COLOR) - 1);
+    term->full = 0;
+}
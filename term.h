@@ -0,0 +1,61 @@
+// Public Domain 2023-Present.
+//
+// The is a free software for the public domain; you can do whatever
+// to it and/or modify it.
+//
+// It is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+///
+///	gameoflife: v0.1 Diffing terminal renderer		<term.h>
+///
+
+#ifndef TERM_H
+#define TERM_H
+
+#include <stddef.h>
+
+#include "grid.h"
+
+// —————————————————————————————————————————————————————————————————————————————
+// TERMINAL RENDERER.
+//
+// Keeps a copy of the cells last sent to the terminal and, each frame, only
+// sends the cursor moves and glyphs of the characters whose cells changed.
+// Only tiles the last step marked dirty are compared, so the cost of a
+// frame follows the amount of change rather than the board size. A frame
+// is built in one buffer allocated up front and sent with one `write`.
+enum Term_Glyphs {
+    TERM_GLYPHS_CELL,     // one cell per 3 columns, " o ".
+    TERM_GLYPHS_HALF,     // 1x2 cells per character, half blocks.
+    TERM_GLYPHS_BRAILLE,  // 2x4 cells per character, braille dots.
+};
+
+struct Term_Renderer {
+    enum Term_Glyphs glyphs;
+    int              cell_w, cell_h;    // cells per character.
+    int              char_w;            // columns per character.
+    int              top;               // terminal row of grid row 0.
+    int              cur_row, cur_col;  // cursor, 0 if unknown.
+    int              full;              // next frame compares every tile.
+    struct Grid      shown;             // cells on screen.
+    char            *buf;
+    size_t           len, cap;
+};
+
+// Set up for a `nrow` x `ncol` board drawn from terminal row `top` down.
+// The first frame clears the screen.
+int  term_init(struct Term_Renderer *term, int nrow, int ncol,
+               enum Term_Glyphs glyphs, int top);
+void term_free(struct Term_Renderer *term);
+
+// Queue text at the top left corner of the screen, e.g. a status header.
+void term_printf(struct Term_Renderer *term, const char *format, ...);
+// Queue the characters changed since the last frame, for tiles dirty in
+// `board` (every tile on the first frame).
+void term_draw(struct Term_Renderer *term, const struct Board *board);
+// Send everything queued in one `write`. Returns 0, or -1 on error.
+int term_flush(struct Term_Renderer *term);
+
+#endif  // TERM_H